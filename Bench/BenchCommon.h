@@ -0,0 +1,122 @@
+#pragma once
+
+// Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "Pacman.h"
+
+// BenchCommon.h
+// Shared pieces of the headless benchmark executables (no window or GL context is created).
+// - Monotonic clock and a compiler barrier for results that would otherwise be optimized away
+// - Deterministic random policy that steers Pac-Man through Pacman::queued, standing in for the keyboard
+// - Command-line options common to every benchmark
+namespace Bench
+{
+	inline uint64_t NowNs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// Forces `value` to be materialized without adding any work of its own
+	template <typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	// xorshift32: tiny, seedable and identical everywhere, so runs are reproducible
+	struct RandomPolicy
+	{
+		uint32_t state;
+
+		explicit RandomPolicy(uint32_t seed) : state(seed ? seed : 0x9E3779B9u) {}
+
+		uint32_t Next()
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+
+		// Queues a new random direction on about one tick in `turnEvery`; Pac-Man takes it at the
+		// next tile centre where it is open, exactly as with held arrow keys
+		void Steer(Pacman& pac, uint32_t turnEvery = 16)
+		{
+			if (Next() % turnEvery != 0 && (pac.queued.x || pac.queued.y))
+			{
+				return;
+			}
+
+			static const Play::Point2f DIRS[4] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+			pac.queued = DIRS[Next() % 4];
+		}
+	};
+
+	struct Options
+	{
+		std::string filter;       // run only benchmarks whose name contains this
+		std::string out;          // JSON destination, stdout when empty
+		std::string label;        // free text copied into the report, e.g. a commit hash
+		double minSeconds = 0.5;  // measuring time per benchmark (or per thread count)
+		int maxThreads = 0;       // 0 = hardware concurrency
+		int episodes = 0;         // fixed episode count instead of a time budget, when > 0
+		bool checkAllocations = false;
+	};
+
+	// Unknown arguments are reported and ignored, so old scripts keep working as options are added
+	inline Options ParseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+			if (!std::strcmp(arg, "--filter") && value) { options.filter = value; ++i; }
+			else if (!std::strcmp(arg, "--out") && value) { options.out = value; ++i; }
+			else if (!std::strcmp(arg, "--label") && value) { options.label = value; ++i; }
+			else if (!std::strcmp(arg, "--min-time") && value) { options.minSeconds = std::atof(value); ++i; }
+			else if (!std::strcmp(arg, "--threads") && value) { options.maxThreads = std::max(1, std::atoi(value)); ++i; }
+			else if (!std::strcmp(arg, "--episodes") && value) { options.episodes = std::max(1, std::atoi(value)); ++i; }
+			else if (!std::strcmp(arg, "--check-allocations")) { options.checkAllocations = true; }
+			else { std::fprintf(stderr, "ignoring unknown argument '%s'\n", arg); }
+		}
+		return options;
+	}
+
+	// Opens the report destination; close with CloseReport
+	inline FILE* OpenReport(const Options& options)
+	{
+		if (options.out.empty())
+		{
+			return stdout;
+		}
+		FILE* file = std::fopen(options.out.c_str(), "w");
+		if (!file)
+		{
+			std::fprintf(stderr, "cannot write '%s', using stdout\n", options.out.c_str());
+			return stdout;
+		}
+		return file;
+	}
+
+	inline void CloseReport(FILE* file)
+	{
+		if (file != stdout)
+		{
+			std::fclose(file);
+		}
+	}
+}
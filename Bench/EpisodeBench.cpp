@@ -0,0 +1,263 @@
+// Includes
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "BenchCommon.h"
+#include "JsonString.h"
+#include "Game.h"
+#include "AllocTracker.h"
+
+// EpisodeBench.cpp
+// End-to-end throughput: whole Pac-Man episodes played headlessly by a seeded random policy.
+// An episode ends on a win (board cleared), a death (first ghost catch) or a time-out. Each thread
+// count from 1 up to --threads (doubling, plus the maximum itself) runs independent games, one per
+// thread, and reports episodes/sec, ticks/sec and sampled tick latency percentiles. The peak RSS is the
+// process's high-water mark over every thread count, so it is reported once for the whole run.
+//
+// Usage: PacmanEpisodeBench [--threads N] [--min-time seconds | --episodes N] [--out file.json] [--label text]
+//        PacmanEpisodeBench --check-allocations [--episodes N]
+// The check mode needs a PACMAN_TRACK_ALLOCATIONS build. It plays episodes on one thread and exits
+// non-zero if any Game::Update after Game::Init allocates from the heap. Such builds also run it
+// under ctest as EpisodeAllocations.
+
+#pragma region Helpers
+namespace {
+
+	constexpr float DT = 1.0f / 60.0f;
+	constexpr int MAX_EPISODE_TICKS = 60 * 60 * 5; // five minutes of game time
+	constexpr uint32_t LATENCY_SAMPLE_EVERY = 16;   // timing every tick would cost more than the tick
+
+	struct ThreadStats
+	{
+		uint64_t episodes = 0, wins = 0, deaths = 0, timeouts = 0;
+		uint64_t ticks = 0;
+		std::vector<uint32_t> latencyNs; // sampled ticks
+	};
+
+	struct RunResult
+	{
+		int threads = 0;
+		double seconds = 0.0;
+		ThreadStats total;
+		uint32_t p50Ns = 0, p99Ns = 0;
+	};
+
+	long PeakRssKb()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+	#if defined(__APPLE__)
+		return usage.ru_maxrss / 1024; // bytes on macOS
+	#else
+		return usage.ru_maxrss;        // kilobytes on Linux
+	#endif
+#else
+		return 0;
+#endif
+	}
+
+	// Plays episodes until `stop` is set (time budget) or `episodeQuota` is reached (fixed count)
+	void PlayEpisodes(int threadIndex, uint64_t episodeQuota, const std::atomic<bool>& stop, ThreadStats& stats)
+	{
+		Game game;
+		uint32_t sampleCountdown = LATENCY_SAMPLE_EVERY;
+
+		while (episodeQuota ? stats.episodes < episodeQuota : !stop.load(std::memory_order_relaxed))
+		{
+			// Seeds depend only on thread and episode number, so a run is reproducible for a given thread count
+			const uint32_t seed = static_cast<uint32_t>(threadIndex) * 1000003u + static_cast<uint32_t>(stats.episodes) + 1u;
+			game.rng.seed(seed);
+			game.Init();
+			Bench::RandomPolicy policy(seed);
+
+			int tick = 0;
+			for (; tick < MAX_EPISODE_TICKS; ++tick)
+			{
+				policy.Steer(*game.pac);
+				if (--sampleCountdown == 0)
+				{
+					sampleCountdown = LATENCY_SAMPLE_EVERY;
+					const uint64_t start = Bench::NowNs();
+					game.Update(DT);
+					stats.latencyNs.push_back(static_cast<uint32_t>(std::min<uint64_t>(Bench::NowNs() - start, UINT32_MAX)));
+				}
+				else
+				{
+					game.Update(DT);
+				}
+
+				if (game.livesLost > 0 || game.pelletsRemaining == 0)
+				{
+					++tick;
+					break;
+				}
+			}
+
+			stats.ticks += tick;
+			++stats.episodes;
+			if (game.livesLost > 0) ++stats.deaths;
+			else if (game.pelletsRemaining == 0) ++stats.wins;
+			else ++stats.timeouts;
+		}
+	}
+
+	RunResult Run(int threads, const Bench::Options& options)
+	{
+		std::vector<ThreadStats> stats(threads);
+		std::atomic<bool> stop{ false };
+		const uint64_t quota = options.episodes > 0 ? static_cast<uint64_t>(options.episodes) : 0;
+
+		const uint64_t start = Bench::NowNs();
+		std::vector<std::thread> workers;
+		for (int t = 0; t < threads; ++t)
+		{
+			// Split a fixed episode count across threads, so every thread count plays the same total
+			const uint64_t share = quota ? (quota + threads - 1 - t) / threads : 0;
+			workers.emplace_back(PlayEpisodes, t, share, std::cref(stop), std::ref(stats[t]));
+		}
+
+		if (!quota)
+		{
+			std::this_thread::sleep_for(std::chrono::duration<double>(options.minSeconds));
+			stop.store(true, std::memory_order_relaxed);
+		}
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+
+		RunResult result;
+		result.threads = threads;
+		result.seconds = (Bench::NowNs() - start) / 1e9;
+		for (ThreadStats& s : stats)
+		{
+			result.total.episodes += s.episodes;
+			result.total.wins += s.wins;
+			result.total.deaths += s.deaths;
+			result.total.timeouts += s.timeouts;
+			result.total.ticks += s.ticks;
+			result.total.latencyNs.insert(result.total.latencyNs.end(), s.latencyNs.begin(), s.latencyNs.end());
+		}
+
+		std::vector<uint32_t>& latency = result.total.latencyNs;
+		if (!latency.empty())
+		{
+			const auto percentile = [&](double p) {
+				const size_t rank = static_cast<size_t>(p * (latency.size() - 1));
+				std::nth_element(latency.begin(), latency.begin() + rank, latency.end());
+				return latency[rank];
+			};
+			result.p50Ns = percentile(0.50);
+			result.p99Ns = percentile(0.99);
+		}
+		return result;
+	}
+
+	void WriteJson(FILE* file, const Bench::Options& options, const std::vector<RunResult>& runs, long peakRssKb)
+	{
+		std::fprintf(file, "{\n  \"suite\": \"PacmanEpisodeBench\",\n  \"version\": 2,\n  \"label\": ");
+		WriteJsonString(file, options.label.c_str());
+		std::fprintf(file, ",\n  \"policy\": \"random\",\n  \"peak_rss_kb\": %ld,\n  \"runs\": [\n", peakRssKb);
+		for (size_t i = 0; i < runs.size(); ++i)
+		{
+			const RunResult& r = runs[i];
+			const double episodesPerSec = r.total.episodes / r.seconds;
+			std::fprintf(file,
+				"    { \"threads\": %d, \"seconds\": %.3f, \"episodes\": %llu, \"wins\": %llu, \"deaths\": %llu, \"timeouts\": %llu, "
+				"\"ticks\": %llu, \"episodes_per_sec\": %.1f, \"episodes_per_sec_per_thread\": %.1f, \"ticks_per_sec\": %.1f, "
+				"\"tick_p50_ns\": %u, \"tick_p99_ns\": %u }%s\n",
+				r.threads, r.seconds,
+				static_cast<unsigned long long>(r.total.episodes), static_cast<unsigned long long>(r.total.wins),
+				static_cast<unsigned long long>(r.total.deaths), static_cast<unsigned long long>(r.total.timeouts),
+				static_cast<unsigned long long>(r.total.ticks),
+				episodesPerSec, episodesPerSec / r.threads, r.total.ticks / r.seconds,
+				r.p50Ns, r.p99Ns,
+				i + 1 < runs.size() ? "," : "");
+		}
+		std::fprintf(file, "  ]\n}\n");
+	}
+
+	int CheckAllocations(const Bench::Options& options)
+	{
+		if (!AllocTracker::IsEnabled())
+		{
+			std::fprintf(stderr, "--check-allocations needs a build with PACMAN_TRACK_ALLOCATIONS\n");
+			return 2;
+		}
+
+		const int episodes = options.episodes > 0 ? options.episodes : 100;
+		uint64_t ticks = 0, allocatingTicks = 0;
+		Game game;
+		for (int e = 0; e < episodes; ++e)
+		{
+			const uint32_t seed = static_cast<uint32_t>(e) + 1u;
+			game.rng.seed(seed);
+			game.Init();
+			Bench::RandomPolicy policy(seed);
+
+			// Init may allocate (maze, FSMs); only ticks are counted
+			AllocTracker::Reset();
+			for (int tick = 0; tick < MAX_EPISODE_TICKS && game.livesLost == 0 && game.pelletsRemaining > 0; ++tick)
+			{
+				policy.Steer(*game.pac);
+				const uint64_t before = AllocTracker::GetTotal().allocations;
+				game.Update(DT);
+				++ticks;
+				if (AllocTracker::GetTotal().allocations != before && allocatingTicks++ == 0)
+				{
+					std::fprintf(stderr, "first allocating tick: episode %d, tick %d\n", e, tick);
+				}
+			}
+
+			if (AllocTracker::GetTotal().allocations != 0)
+			{
+				AllocTracker::PrintAllocations(stderr);
+			}
+		}
+
+		std::fprintf(stderr, "%llu of %llu ticks allocated\n",
+			static_cast<unsigned long long>(allocatingTicks), static_cast<unsigned long long>(ticks));
+		return allocatingTicks == 0 ? 0 : 1;
+	}
+
+}
+#pragma endregion
+
+int main(int argc, char** argv)
+{
+	const Bench::Options options = Bench::ParseOptions(argc, argv);
+	if (options.checkAllocations)
+	{
+		return CheckAllocations(options);
+	}
+
+	const int maxThreads = options.maxThreads > 0 ? options.maxThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	std::vector<RunResult> runs;
+	for (int threads = 1; ; threads = std::min(threads * 2, maxThreads))
+	{
+		runs.push_back(Run(threads, options));
+		const RunResult& r = runs.back();
+		std::fprintf(stderr, "%3d threads: %10.1f episodes/s %14.1f ticks/s  p50 %6u ns  p99 %6u ns\n",
+			r.threads, r.total.episodes / r.seconds, r.total.ticks / r.seconds, r.p50Ns, r.p99Ns);
+		if (threads == maxThreads)
+		{
+			break;
+		}
+	}
+
+	const long peakRssKb = PeakRssKb();
+	std::fprintf(stderr, "peak RSS %ld KB\n", peakRssKb);
+
+	FILE* report = Bench::OpenReport(options);
+	WriteJson(report, options, runs, peakRssKb);
+	Bench::CloseReport(report);
+	return 0;
+}
@@ -0,0 +1,261 @@
+// Includes
+#include <algorithm>
+#include <vector>
+
+#include "BenchCommon.h"
+#include "JsonString.h"
+#include "Game.h"
+#include "MazeGenerator.h"
+#include "FSM/GhostStates.h"
+
+// MicroBench.cpp
+// Headless microbenchmarks of the simulation hot paths.
+// Each benchmark is calibrated to a batch size, then timed over REPEATS batches; the median ns/op is
+// reported. Output is JSON with a fixed key order and number format so runs diff cleanly across commits.
+//
+// Usage: PacmanMicroBench [--filter text] [--min-time seconds] [--out file.json] [--label text]
+
+#pragma region Helpers
+namespace {
+
+	constexpr float DT = 1.0f / 60.0f;
+	constexpr int REPEATS = 5;
+
+	struct Result
+	{
+		std::string name;
+		const char* unit; // what one op is: "tick" or "call"
+		uint64_t iterations;
+		double nsPerOp;
+	};
+
+	class Suite
+	{
+	public:
+		explicit Suite(const Bench::Options& options) : m_options(options) {}
+
+		bool Selected(const char* name) const
+		{
+			return m_options.filter.empty() || std::string(name).find(m_options.filter) != std::string::npos;
+		}
+
+		template <typename Op>
+		void Run(const char* name, const char* unit, Op&& op)
+		{
+			if (!Selected(name))
+			{
+				return;
+			}
+
+			// Calibration doubles as warm-up: grow the batch until one takes its share of the time budget
+			const uint64_t targetNs = static_cast<uint64_t>(m_options.minSeconds * 1e9 / REPEATS);
+			uint64_t batch = 1;
+			uint64_t elapsed = TimeBatch(op, batch);
+			while (elapsed < targetNs)
+			{
+				const uint64_t scaled = elapsed > 0 ? static_cast<uint64_t>(batch * 1.2 * targetNs / elapsed) : batch * 10;
+				batch = std::clamp<uint64_t>(scaled, batch + 1, batch * 10);
+				elapsed = TimeBatch(op, batch);
+			}
+
+			double samples[REPEATS];
+			for (double& sample : samples)
+			{
+				sample = static_cast<double>(TimeBatch(op, batch)) / batch;
+			}
+			std::sort(samples, samples + REPEATS);
+
+			m_results.push_back({ name, unit, batch * REPEATS, samples[REPEATS / 2] });
+			std::fprintf(stderr, "%-44s %12.1f ns/op\n", name, samples[REPEATS / 2]);
+		}
+
+		void WriteJson(FILE* file) const
+		{
+			std::fprintf(file, "{\n  \"suite\": \"PacmanMicroBench\",\n  \"version\": 1,\n  \"label\": ");
+			WriteJsonString(file, m_options.label.c_str());
+			std::fprintf(file, ",\n  \"benchmarks\": [\n");
+			for (size_t i = 0; i < m_results.size(); ++i)
+			{
+				const Result& r = m_results[i];
+				std::fprintf(file, "    { \"name\": ");
+				WriteJsonString(file, r.name.c_str());
+				std::fprintf(file, ", \"unit\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f }%s\n",
+					r.unit, static_cast<unsigned long long>(r.iterations), r.nsPerOp, 1e9 / r.nsPerOp,
+					i + 1 < m_results.size() ? "," : "");
+			}
+			std::fprintf(file, "  ]\n}\n");
+		}
+
+	private:
+		template <typename Op>
+		static uint64_t TimeBatch(Op& op, uint64_t count)
+		{
+			const uint64_t start = Bench::NowNs();
+			for (uint64_t i = 0; i < count; ++i)
+			{
+				op();
+			}
+			return Bench::NowNs() - start;
+		}
+
+		const Bench::Options& m_options;
+		std::vector<Result> m_results;
+	};
+
+	// Whole-game tick under the random policy; restarts when the board is cleared
+	void BenchGameUpdate(Suite& suite, const char* name, const Maze* layout)
+	{
+		if (!suite.Selected(name))
+		{
+			return;
+		}
+
+		Game game;
+		layout ? game.Init(*layout) : game.Init();
+		Bench::RandomPolicy policy(1);
+		suite.Run(name, "tick", [&] {
+			policy.Steer(*game.pac);
+			game.Update(DT);
+			if (game.pelletsRemaining == 0)
+			{
+				layout ? game.Init(*layout) : game.Init();
+			}
+		});
+	}
+
+	// One ghost held in `state` (re-entered if its state machine leaves it, e.g. Eaten reaching home)
+	void BenchGhostUpdate(Suite& suite, const char* name, GhostState state)
+	{
+		if (!suite.Selected(name))
+		{
+			return;
+		}
+
+		Game game;
+		game.Init();
+		game.gameStarted = true;
+		Ghost& ghost = *game.ghosts[0];
+		ghost.SetState(state, &game);
+		suite.Run(name, "tick", [&] {
+			Bench::DoNotOptimize(ghost.Update(&game, game.pac->gx, game.pac->gy, DT));
+			if (ghost.GetState() != state)
+			{
+				ghost.SetState(state, &game);
+			}
+		});
+	}
+
+}
+#pragma endregion
+
+int main(int argc, char** argv)
+{
+	const Bench::Options options = Bench::ParseOptions(argc, argv);
+	Suite suite(options);
+
+	// Game::Update
+	BenchGameUpdate(suite, "Game::Update/default_board", nullptr);
+	{
+		MazeGenParams params;
+		params.width = params.height = 127;
+		Maze generated;
+		GenerateMaze(params, generated);
+		BenchGameUpdate(suite, "Game::Update/generated_127x127", &generated);
+	}
+
+	// Ghost::Update per state
+	BenchGhostUpdate(suite, "Ghost::Update/Idle", GhostState::Idle);
+	BenchGhostUpdate(suite, "Ghost::Update/Scatter", GhostState::Scatter);
+	BenchGhostUpdate(suite, "Ghost::Update/Chase", GhostState::Chase);
+	BenchGhostUpdate(suite, "Ghost::Update/Frightened", GhostState::Frightened);
+	BenchGhostUpdate(suite, "Ghost::Update/Eaten", GhostState::Eaten);
+
+	// Movement decisions over every open tile of the default board
+	{
+		Game game;
+		game.Init();
+		std::vector<std::pair<int, int>> open;
+		for (int y = 0; y < game.maze.height; ++y)
+		{
+			for (int x = 0; x < game.maze.width; ++x)
+			{
+				if (game.maze[y][x] != TileType::WALL)
+				{
+					open.emplace_back(x, y);
+				}
+			}
+		}
+
+		const Play::Point2f dirs[4] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+		size_t i = 0;
+		suite.Run("GhostStates::GetLegalDirs", "call", [&] {
+			const auto& [x, y] = open[i % open.size()];
+			Bench::DoNotOptimize(GetLegalDirs(&game, x, y, dirs[i & 3]).size());
+			++i;
+		});
+
+		std::vector<DirList> legal;
+		legal.reserve(open.size());
+		for (size_t t = 0; t < open.size(); ++t)
+		{
+			legal.push_back(GetLegalDirs(&game, open[t].first, open[t].second, dirs[t & 3]));
+		}
+
+		i = 0;
+		suite.Run("GhostStates::ChooseBestDir", "call", [&] {
+			const size_t t = i % open.size();
+			const auto& [tx, ty] = open[(i * 7) % open.size()];
+			Bench::DoNotOptimize(ChooseBestDir(open[t].first, open[t].second, tx, ty, legal[t], game.rng));
+			++i;
+		});
+	}
+
+	// SpawnPowerUp on a full board; the chosen tile is put back so every call sees the same board
+	{
+		Game game;
+		game.Init();
+		suite.Run("Game::SpawnPowerUp", "call", [&] {
+			game.SpawnPowerUp();
+			const int idx = game.GetDirtyTiles().back();
+			game.SetTile(idx % game.maze.width, idx / game.maze.width, TileType::PELLET);
+			game.FlushDirtyTiles();
+		});
+	}
+
+	// DrawMaze without a window: a zero-sized software target issues every draw call and clips it away
+	// (the null backend), a real one adds the CPU rasterizer
+	{
+		Game game;
+		game.Init();
+
+		Play::SoftwareTarget null;
+		Play::SetSoftwareTarget(&null);
+		suite.Run("Game::DrawMaze/null_backend", "call", [&] { game.DrawMaze(); });
+
+		std::vector<uint32_t> pixels(static_cast<size_t>(Cfg::DISPLAY_W) * Cfg::DISPLAY_H);
+		Play::SoftwareTarget software;
+		software.pixels = reinterpret_cast<uint8_t*>(pixels.data());
+		software.width = Cfg::DISPLAY_W;
+		software.height = Cfg::DISPLAY_H;
+		software.pitch = Cfg::DISPLAY_W * 4;
+		Play::SetSoftwareTarget(&software);
+		suite.Run("Game::DrawMaze/software_rgba8", "call", [&] { game.DrawMaze(); });
+
+		Play::SetSoftwareTarget(nullptr);
+	}
+
+	// FSM transitions with their OnExit/OnEnter work, cycling through every legal edge of the loop
+	{
+		Game game;
+		game.Init();
+		Ghost& ghost = *game.ghosts[0];
+		const GhostState cycle[4] = { GhostState::Scatter, GhostState::Chase, GhostState::Frightened, GhostState::Eaten };
+		size_t i = 0;
+		suite.Run("GhostStateMachine::SetState/churn", "call", [&] { ghost.SetState(cycle[i++ & 3], &game); });
+	}
+
+	FILE* report = Bench::OpenReport(options);
+	suite.WriteJson(report);
+	Bench::CloseReport(report);
+	return 0;
+}
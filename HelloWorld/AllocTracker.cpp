@@ -0,0 +1,187 @@
+// This file's header
+#include "AllocTracker.h"
+
+// Other includes
+#include <cstdlib>
+#include <new>
+
+#pragma region Helpers
+namespace {
+
+	// Plain data only: operator new may run before or during this thread's other thread_local constructors
+	struct ThreadCounters
+	{
+		AllocCounts phases[ALLOC_PHASE_COUNT];
+		AllocPhase active;
+	};
+
+	thread_local ThreadCounters t_counters{};
+
+	const char* const PHASE_NAMES[ALLOC_PHASE_COUNT] = {
+		"Other", "SpawnPowerUp", "GetLegalDirs", "ChooseBestDir", "FsmSetup"
+	};
+
+#ifdef PACMAN_TRACK_ALLOCATIONS
+	void Count(std::size_t size)
+	{
+		AllocCounts& counts = t_counters.phases[static_cast<int>(t_counters.active)];
+		++counts.allocations;
+		counts.bytes += size;
+	}
+
+	void* Allocate(std::size_t size)
+	{
+		Count(size);
+		return std::malloc(size ? size : 1);
+	}
+
+	void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+	{
+		Count(size);
+		const std::size_t align = static_cast<std::size_t>(alignment);
+	#ifdef _MSC_VER
+		return _aligned_malloc(size ? size : 1, align);
+	#else
+		// aligned_alloc wants a whole number of alignments
+		return std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+	#endif
+	}
+
+	void FreeAligned(void* p)
+	{
+	#ifdef _MSC_VER
+		_aligned_free(p);
+	#else
+		std::free(p);
+	#endif
+	}
+#endif
+
+}
+#pragma endregion
+
+namespace AllocTracker
+{
+	bool IsEnabled()
+	{
+#ifdef PACMAN_TRACK_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	AllocPhase SetPhase(AllocPhase phase)
+	{
+		const AllocPhase previous = t_counters.active;
+		t_counters.active = phase;
+		return previous;
+	}
+
+	AllocCounts GetCounts(AllocPhase phase)
+	{
+		return t_counters.phases[static_cast<int>(phase)];
+	}
+
+	AllocCounts GetTotal()
+	{
+		AllocCounts total;
+		for (const AllocCounts& counts : t_counters.phases)
+		{
+			total.allocations += counts.allocations;
+			total.bytes += counts.bytes;
+		}
+		return total;
+	}
+
+	void Reset()
+	{
+		for (AllocCounts& counts : t_counters.phases)
+		{
+			counts = {};
+		}
+	}
+
+	const char* PhaseName(AllocPhase phase)
+	{
+		return PHASE_NAMES[static_cast<int>(phase)];
+	}
+
+	void PrintAllocations(FILE* file)
+	{
+		if (!IsEnabled())
+		{
+			std::fprintf(file, "allocation tracking not compiled in (PACMAN_TRACK_ALLOCATIONS)\n");
+			return;
+		}
+
+		for (int i = 0; i < ALLOC_PHASE_COUNT; ++i)
+		{
+			const AllocCounts& counts = t_counters.phases[i];
+			std::fprintf(file, "%-16s %10llu allocations %14llu bytes\n", PHASE_NAMES[i],
+				static_cast<unsigned long long>(counts.allocations), static_cast<unsigned long long>(counts.bytes));
+		}
+	}
+}
+
+#ifdef PACMAN_TRACK_ALLOCATIONS
+// Replacement global allocation functions. Every other form (array, sized and nothrow delete, ...)
+// has a standard default that forwards to one of these.
+void* operator new(std::size_t size)
+{
+	if (void* p = Allocate(size))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	if (void* p = AllocateAligned(size, alignment))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	FreeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+	FreeAligned(p);
+}
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <cstdio>
+
+// AllocTracker.h
+// Opt-in heap allocation counter for the raylib build (portable counterpart of Play.h's PrintAllocations).
+// - With PACMAN_TRACK_ALLOCATIONS defined (CMake option of the same name), the global operator new/delete
+//   are replaced and every allocation is counted against the current thread's active phase
+// - ALLOC_SCOPE(phase) makes `phase` active for the rest of the enclosing block; unattributed
+//   allocations land in AllocPhase::Other
+// - Counters are per thread, so parallel games can each check their own ticks
+// Without the option, ALLOC_SCOPE compiles to nothing and all counters stay zero.
+
+enum class AllocPhase : uint8_t
+{
+	Other,
+	SpawnPowerUp,
+	GetLegalDirs,
+	ChooseBestDir,
+	FsmSetup,
+	Count
+};
+
+constexpr int ALLOC_PHASE_COUNT = static_cast<int>(AllocPhase::Count);
+
+struct AllocCounts
+{
+	uint64_t allocations = 0;
+	uint64_t bytes = 0;
+};
+
+namespace AllocTracker
+{
+	// True when operator new is being counted
+	bool IsEnabled();
+
+	// Returns the phase that was active before
+	AllocPhase SetPhase(AllocPhase phase);
+
+	// This thread's counters since the last Reset
+	AllocCounts GetCounts(AllocPhase phase);
+	AllocCounts GetTotal();
+	void Reset();
+
+	const char* PhaseName(AllocPhase phase);
+	void PrintAllocations(FILE* file);
+
+	struct Scope
+	{
+		explicit Scope(AllocPhase phase) : previous(SetPhase(phase)) {}
+		~Scope() { SetPhase(previous); }
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		AllocPhase previous;
+	};
+}
+
+#ifdef PACMAN_TRACK_ALLOCATIONS
+	#define ALLOC_CONCAT_INNER(a, b) a##b
+	#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+	#define ALLOC_SCOPE(phase) const AllocTracker::Scope ALLOC_CONCAT(allocScope_, __LINE__)(phase)
+#else
+	#define ALLOC_SCOPE(phase) ((void)0)
+#endif
@@ -0,0 +1,115 @@
+// This file's header
+#include "Arena.h"
+
+// Other includes
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+
+#pragma region Helpers
+namespace {
+
+	std::byte* AlignUp(std::byte* p, size_t align)
+	{
+		const uintptr_t value = reinterpret_cast<uintptr_t>(p);
+		return reinterpret_cast<std::byte*>((value + align - 1) & ~(static_cast<uintptr_t>(align) - 1));
+	}
+
+}
+#pragma endregion
+
+Arena::Arena(void* buffer, size_t size)
+	: m_first(static_cast<std::byte*>(buffer)), m_firstSize(size)
+{
+	m_cursor = m_first;
+	m_end = m_first + m_firstSize;
+}
+
+Arena::Arena(size_t firstBlockSize)
+	: m_first(static_cast<std::byte*>(std::malloc(firstBlockSize))), m_firstSize(firstBlockSize), m_ownsFirst(true)
+{
+	assert(m_first && "Arena: out of memory");
+	m_cursor = m_first;
+	m_end = m_first + m_firstSize;
+}
+
+Arena::~Arena()
+{
+	Reset();
+
+	while (m_overflow)
+	{
+		Block* next = m_overflow->next;
+		std::free(m_overflow);
+		m_overflow = next;
+	}
+
+	if (m_ownsFirst)
+	{
+		std::free(m_first);
+	}
+}
+
+void* Arena::Allocate(size_t size, size_t align)
+{
+	assert(align != 0 && (align & (align - 1)) == 0 && "Arena: alignment must be a power of two");
+	std::byte* p = AlignUp(m_cursor, align);
+	if (p + size <= m_end)
+	{
+		m_cursor = p + size;
+		return p;
+	}
+	return AllocateSlow(size, align);
+}
+
+void* Arena::AllocateSlow(size_t size, size_t align)
+{
+	// Reuse the blocks kept from before the last Reset while they are big enough
+	Block* next = m_current ? m_current->next : m_overflow;
+	while (next && next->size < size + align)
+	{
+		next = next->next;
+	}
+
+	if (!next)
+	{
+		// Grow geometrically so a badly sized first block costs few mallocs
+		const size_t lastSize = m_current ? m_current->size : m_firstSize;
+		const size_t blockSize = std::max(size + align, lastSize * 2);
+		next = static_cast<Block*>(std::malloc(sizeof(Block) + blockSize));
+		assert(next && "Arena: out of memory");
+		next->size = blockSize;
+
+		// Append, keeping oldest-first order
+		next->next = nullptr;
+		Block** tail = &m_overflow;
+		while (*tail)
+		{
+			tail = &(*tail)->next;
+		}
+		*tail = next;
+	}
+
+	m_current = next;
+	m_cursor = reinterpret_cast<std::byte*>(next + 1);
+	m_end = m_cursor + next->size;
+
+	std::byte* p = AlignUp(m_cursor, align);
+	m_cursor = p + size;
+	return p;
+}
+
+void Arena::Reset()
+{
+	while (m_finalizers)
+	{
+		Finalizer* finalizer = m_finalizers;
+		m_finalizers = finalizer->next;
+		finalizer->destroy(finalizer->object);
+	}
+
+	m_current = nullptr;
+	m_cursor = m_first;
+	m_end = m_first + m_firstSize;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+// Includes
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Arena.h
+// Monotonic arena: objects are bump-allocated and only released all at once, by Reset or destruction.
+// - The first block can be caller storage (e.g. a member array), so an owner that sizes it right never calls malloc
+// - When a block is full, overflow blocks are malloc'd and kept across Reset for reuse
+// - Objects with non-trivial destructors get a finalizer record in the arena; Reset runs them newest first
+// Objects never move, so pointers between arena objects stay valid until Reset.
+class Arena
+{
+public:
+	// First block is `buffer`, which the arena does not own
+	Arena(void* buffer, size_t size);
+	// First block is malloc'd
+	explicit Arena(size_t firstBlockSize = 4096);
+	~Arena();
+
+	// non-copyable
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	void* Allocate(size_t size, size_t align);
+
+	template <typename T, typename... Args>
+	T* Create(Args&&... args)
+	{
+		if constexpr (std::is_trivially_destructible_v<T>)
+		{
+			return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+		else
+		{
+			void* finalizerMemory = Allocate(sizeof(Finalizer), alignof(Finalizer));
+			T* object = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			// Linked only once constructed, so a throwing constructor is never destroyed
+			m_finalizers = new (finalizerMemory) Finalizer{ [](void* p) { static_cast<T*>(p)->~T(); }, object, m_finalizers };
+			return object;
+		}
+	}
+
+	// Destroys every object (newest first) and rewinds to the start of the first block
+	void Reset();
+
+	// True once anything spilled past the first block
+	bool HasOverflowed() const { return m_overflow != nullptr; }
+
+private:
+	struct Finalizer
+	{
+		void (*destroy)(void*);
+		void* object;
+		Finalizer* next;
+	};
+
+	// Overflow block header; the usable bytes follow it
+	struct Block
+	{
+		Block* next;
+		size_t size;
+	};
+
+	void* AllocateSlow(size_t size, size_t align);
+
+	std::byte* m_first = nullptr;
+	size_t m_firstSize = 0;
+	bool m_ownsFirst = false;
+
+	Block* m_overflow = nullptr; // oldest first
+	Block* m_current = nullptr;  // overflow block being filled, nullptr while in the first block
+	std::byte* m_cursor = nullptr;
+	std::byte* m_end = nullptr;
+
+	Finalizer* m_finalizers = nullptr;
+};
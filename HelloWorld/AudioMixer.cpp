@@ -0,0 +1,700 @@
+// This file's header
+#include "AudioMixer.h"
+
+// Other includes
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "raylib.h"
+#include "MappedFile.h"
+#include "SpscQueue.h"
+
+#pragma region Helpers
+namespace {
+
+	constexpr size_t STREAM_CHUNK_FRAMES = 4096; // ~93 ms at 44.1 kHz, so two chunks ride out a slow disk read
+
+	// One half of a streamed sound's double buffer. `ready` hands it over: the streamer fills it while
+	// false, the callback plays it while true and clears it once done.
+	struct StreamChunk
+	{
+		int16_t samples[STREAM_CHUNK_FRAMES * 2]; // interleaved stereo at the mixer rate
+		uint32_t frames = 0;
+		uint32_t generation = 0; // the play it belongs to; chunks from an earlier play are skipped
+		bool last = false;       // a one-shot's final chunk
+		std::atomic<bool> ready{ false };
+	};
+
+	struct SoundStream
+	{
+		MappedFile file;
+		const uint8_t* pcm = nullptr; // 16-bit samples within the mapping
+		size_t sourceFrames = 0;
+		int sourceRate = 0, channels = 0;
+
+		StreamChunk chunks[2];
+		// Latest play as generation << 1 | loop, published by the callback for the streamer
+		std::atomic<uint32_t> request{ 0 };
+
+		// Streamer thread only
+		uint32_t generation = 0;
+		bool loop = false, finished = false;
+		uint64_t position = 0; // in source frames, 16.16 fixed point
+		int fillChunk = 0;
+
+		// Audio callback only
+		uint32_t plays = 0;
+		int playChunk = 0;
+		uint32_t playFrame = 0;
+		bool started = false; // a chunk of the current play has arrived, so a missing one is an underrun
+	};
+
+	struct SoundData
+	{
+		std::string name;             // file name without extension, uppercase
+		std::vector<int16_t> samples; // interleaved stereo, empty when streamed
+		size_t frames = 0;
+		std::unique_ptr<SoundStream> stream;
+	};
+
+	struct Voice
+	{
+		VoiceId id = INVALID_VOICE; // INVALID_VOICE while the slot is free
+		const SoundData* sound = nullptr;
+		size_t frame = 0;           // next frame to mix
+		int32_t gain = 0;           // volume in 4.12 fixed point
+		bool loop = false;
+		uint32_t generation = 0;    // streamed sounds: the play this voice is
+	};
+
+	struct Command
+	{
+		enum class Type : uint8_t { Play, StopVoice, StopSound };
+
+		Type type = Type::Play;
+		bool loop = false;
+		int32_t gain = 0;
+		SoundId sound = INVALID_SOUND;
+		VoiceId voice = INVALID_VOICE;
+	};
+
+	constexpr size_t QUEUE_DEPTH = 64;
+	constexpr size_t VOICE_COUNT = 16;
+	constexpr int GAIN_SHIFT = 12;
+	constexpr int MIX_CHUNK_FRAMES = 256; // callbacks bigger than this are mixed in chunks
+
+	// Read-only while the stream runs (apart from each SoundStream's own state)
+	std::vector<SoundData> s_sounds;
+	std::atomic<bool> s_running{ false };
+	bool s_device = false; // false: no stream, Mixer::Mix is the callback
+	AudioStream s_stream{};
+	int s_sampleRate = 0;
+
+	std::thread s_streamer;
+	std::atomic<bool> s_streaming{ false };
+
+	// Game thread only
+	VoiceId s_nextVoice = 1;
+
+	SpscQueue<Command, QUEUE_DEPTH> s_queue;
+	std::atomic<uint64_t> s_played{ 0 }, s_stolen{ 0 }, s_dropped{ 0 }, s_underruns{ 0 };
+
+	// Audio callback only
+	Voice s_voices[VOICE_COUNT];
+	int32_t s_accumulator[MIX_CHUNK_FRAMES * 2];
+
+	std::string ToUpper(std::string text)
+	{
+		for (char& c : text)
+		{
+			c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+		}
+		return text;
+	}
+
+	void Push(const Command& command)
+	{
+		if (!s_queue.TryPush(command))
+		{
+			s_dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// A free slot, else the oldest one-shot, else the oldest voice (ids only grow, wrap aside)
+	Voice& AllocateVoice()
+	{
+		Voice* oldest = nullptr;
+		for (Voice& v : s_voices)
+		{
+			if (v.id == INVALID_VOICE)
+			{
+				return v;
+			}
+			if (!oldest || (oldest->loop && !v.loop) || (oldest->loop == v.loop && v.id < oldest->id))
+			{
+				oldest = &v;
+			}
+		}
+		s_stolen.fetch_add(1, std::memory_order_relaxed);
+		return *oldest;
+	}
+
+	void ApplyCommands()
+	{
+		Command command;
+		while (s_queue.TryPop(command))
+		{
+			switch (command.type)
+			{
+			case Command::Type::Play:
+			{
+				const SoundData& sound = s_sounds[command.sound];
+				Voice* voice = nullptr;
+				uint32_t generation = 0;
+				if (SoundStream* stream = sound.stream.get())
+				{
+					// A streamed sound restarts its one voice, and asks the streamer to start over
+					for (Voice& v : s_voices)
+					{
+						if (v.id != INVALID_VOICE && v.sound == &sound)
+						{
+							voice = &v;
+						}
+					}
+					generation = ++stream->plays;
+					stream->request.store(generation << 1 | (command.loop ? 1u : 0u), std::memory_order_release);
+					stream->playFrame = 0;
+					stream->started = false;
+				}
+				if (!voice)
+				{
+					voice = &AllocateVoice();
+				}
+				*voice = { command.voice, &sound, 0, command.gain, command.loop, generation };
+				s_played.fetch_add(1, std::memory_order_relaxed);
+				break;
+			}
+			case Command::Type::StopVoice:
+				for (Voice& v : s_voices)
+				{
+					if (v.id == command.voice)
+					{
+						v.id = INVALID_VOICE;
+					}
+				}
+				break;
+			case Command::Type::StopSound:
+				for (Voice& v : s_voices)
+				{
+					if (v.id != INVALID_VOICE && v.sound == &s_sounds[command.sound])
+					{
+						v.id = INVALID_VOICE;
+					}
+				}
+				break;
+			}
+		}
+	}
+
+	// Adds `frames` frames of the voice into the accumulator, freeing it when a one-shot ends
+	void MixVoice(Voice& v, int32_t* accumulator, size_t frames)
+	{
+		const SoundData& sound = *v.sound;
+		size_t done = 0;
+		while (done < frames)
+		{
+			if (v.frame == sound.frames)
+			{
+				if (!v.loop)
+				{
+					break;
+				}
+				v.frame = 0;
+			}
+
+			const size_t count = std::min(frames - done, sound.frames - v.frame);
+			const int16_t* src = sound.samples.data() + v.frame * 2;
+			int32_t* dst = accumulator + done * 2;
+			for (size_t i = 0; i < count * 2; ++i)
+			{
+				dst[i] += (src[i] * v.gain) >> GAIN_SHIFT;
+			}
+			v.frame += count;
+			done += count;
+		}
+
+		if (!v.loop && v.frame == sound.frames)
+		{
+			v.id = INVALID_VOICE;
+		}
+	}
+
+	// Plays the stream's chunks in order, handing each back to the streamer once it is used up
+	void MixStream(Voice& v, int32_t* accumulator, size_t frames)
+	{
+		SoundStream& stream = *v.sound->stream;
+		size_t done = 0;
+		while (done < frames)
+		{
+			StreamChunk& chunk = stream.chunks[stream.playChunk];
+			if (!chunk.ready.load(std::memory_order_acquire))
+			{
+				if (stream.started)
+				{
+					s_underruns.fetch_add(1, std::memory_order_relaxed);
+				}
+				return;
+			}
+			if (chunk.generation != v.generation)
+			{
+				chunk.ready.store(false, std::memory_order_release);
+				stream.playChunk ^= 1;
+				continue;
+			}
+			stream.started = true;
+
+			const size_t count = std::min<size_t>(frames - done, chunk.frames - stream.playFrame);
+			const int16_t* src = chunk.samples + stream.playFrame * 2;
+			int32_t* dst = accumulator + done * 2;
+			for (size_t i = 0; i < count * 2; ++i)
+			{
+				dst[i] += (src[i] * v.gain) >> GAIN_SHIFT;
+			}
+			stream.playFrame += static_cast<uint32_t>(count);
+			done += count;
+
+			if (stream.playFrame == chunk.frames)
+			{
+				const bool last = chunk.last;
+				chunk.ready.store(false, std::memory_order_release);
+				stream.playChunk ^= 1;
+				stream.playFrame = 0;
+				if (last)
+				{
+					v.id = INVALID_VOICE;
+					return;
+				}
+			}
+		}
+	}
+
+	// One callback's worth: applies the queued commands, then mixes every voice into out
+	void MixFrames(int16_t* out, unsigned int frames)
+	{
+		ApplyCommands();
+
+		while (frames > 0)
+		{
+			const unsigned int chunk = std::min(frames, static_cast<unsigned int>(MIX_CHUNK_FRAMES));
+			std::fill_n(s_accumulator, chunk * 2, 0);
+			for (Voice& v : s_voices)
+			{
+				if (v.id != INVALID_VOICE)
+				{
+					if (v.sound->stream)
+					{
+						MixStream(v, s_accumulator, chunk);
+					}
+					else
+					{
+						MixVoice(v, s_accumulator, chunk);
+					}
+				}
+			}
+			for (unsigned int i = 0; i < chunk * 2; ++i)
+			{
+				out[i] = static_cast<int16_t>(std::clamp(s_accumulator[i], -32768, 32767));
+			}
+			out += chunk * 2;
+			frames -= chunk;
+		}
+	}
+
+	// Runs on the audio device's thread
+	void MixCallback(void* buffer, unsigned int frames)
+	{
+		MixFrames(static_cast<int16_t*>(buffer), frames);
+	}
+
+	int16_t ReadSample(const uint8_t* pcm, size_t index)
+	{
+		int16_t sample;
+		std::memcpy(&sample, pcm + index * 2, sizeof(sample));
+		return sample;
+	}
+
+	// Converts the next chunk to stereo at the mixer rate, interpolating linearly between source frames.
+	// Equal rates step exactly one frame at a time, so the samples are copied unchanged.
+	void FillChunk(SoundStream& stream, StreamChunk& chunk)
+	{
+		const uint64_t step = (static_cast<uint64_t>(stream.sourceRate) << 16) / static_cast<uint64_t>(s_sampleRate);
+		const uint64_t end = static_cast<uint64_t>(stream.sourceFrames) << 16;
+		const int channels = stream.channels;
+
+		uint32_t frames = 0;
+		while (frames < STREAM_CHUNK_FRAMES)
+		{
+			if (stream.position >= end)
+			{
+				if (!stream.loop)
+				{
+					stream.finished = true;
+					break;
+				}
+				stream.position -= end;
+			}
+
+			const size_t index = static_cast<size_t>(stream.position >> 16);
+			const size_t next = index + 1 < stream.sourceFrames ? index + 1 : (stream.loop ? 0 : index);
+			const int32_t frac = static_cast<int32_t>(stream.position & 0xFFFF);
+			for (int c = 0; c < 2; ++c)
+			{
+				const int channel = std::min(c, channels - 1);
+				const int32_t a = ReadSample(stream.pcm, index * channels + channel);
+				const int32_t b = ReadSample(stream.pcm, next * channels + channel);
+				chunk.samples[frames * 2 + c] = static_cast<int16_t>(a + (((b - a) * frac) >> 16));
+			}
+			stream.position += step;
+			++frames;
+		}
+
+		chunk.frames = frames;
+		chunk.generation = stream.generation;
+		chunk.last = stream.finished;
+	}
+
+	// Keeps every playing stream's free chunks filled; all the file reading (page faults) happens here
+	void StreamerLoop()
+	{
+		while (s_streaming.load(std::memory_order_acquire))
+		{
+			bool filled = false;
+			for (SoundData& sound : s_sounds)
+			{
+				SoundStream* stream = sound.stream.get();
+				if (!stream)
+				{
+					continue;
+				}
+
+				const uint32_t request = stream->request.load(std::memory_order_acquire);
+				if (request >> 1 != stream->generation)
+				{
+					stream->generation = request >> 1;
+					stream->loop = (request & 1) != 0;
+					stream->finished = false;
+					stream->position = 0;
+				}
+				if (stream->generation == 0 || stream->finished)
+				{
+					continue;
+				}
+
+				// Chunks are filled and played strictly alternately, so only the next one can be free
+				StreamChunk& chunk = stream->chunks[stream->fillChunk];
+				if (chunk.ready.load(std::memory_order_acquire))
+				{
+					continue;
+				}
+				FillChunk(*stream, chunk);
+				chunk.ready.store(true, std::memory_order_release);
+				stream->fillChunk ^= 1;
+				filled = true;
+			}
+
+			if (!filled)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+		}
+	}
+
+	// Maps a 16-bit PCM .wav for streaming; anything else is left to LoadSound
+	bool OpenStream(const std::filesystem::path& path, SoundData& sound)
+	{
+		auto stream = std::make_unique<SoundStream>();
+		if (!stream->file.Open(path.string()))
+		{
+			return false;
+		}
+
+		const uint8_t* data = stream->file.Data();
+		const size_t size = stream->file.Size();
+		if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0)
+		{
+			return false;
+		}
+
+		// Walk the chunks for the format and the samples
+		bool pcm16 = false;
+		size_t offset = 12;
+		while (offset + 8 <= size)
+		{
+			uint32_t chunkSize;
+			std::memcpy(&chunkSize, data + offset + 4, sizeof(chunkSize));
+			const uint8_t* body = data + offset + 8;
+			const size_t available = std::min<size_t>(chunkSize, size - offset - 8);
+
+			if (std::memcmp(data + offset, "fmt ", 4) == 0 && available >= 16)
+			{
+				uint16_t format, channels, bits;
+				uint32_t rate;
+				std::memcpy(&format, body, sizeof(format));
+				std::memcpy(&channels, body + 2, sizeof(channels));
+				std::memcpy(&rate, body + 4, sizeof(rate));
+				std::memcpy(&bits, body + 14, sizeof(bits));
+				// WAVE_FORMAT_EXTENSIBLE keeps the real format in the first two bytes of its subformat GUID
+				if (format == 0xFFFE && available >= 26)
+				{
+					std::memcpy(&format, body + 24, sizeof(format));
+				}
+				pcm16 = format == 1 && bits == 16 && (channels == 1 || channels == 2) && rate > 0;
+				stream->channels = channels;
+				stream->sourceRate = static_cast<int>(rate);
+			}
+			else if (std::memcmp(data + offset, "data", 4) == 0 && pcm16)
+			{
+				stream->pcm = body;
+				stream->sourceFrames = available / (2 * static_cast<size_t>(stream->channels));
+				break;
+			}
+
+			// Chunks are padded to an even size
+			offset += 8 + static_cast<size_t>(chunkSize) + (chunkSize & 1);
+		}
+		if (!stream->pcm || stream->sourceFrames == 0)
+		{
+			return false;
+		}
+
+		sound.name = ToUpper(path.stem().string());
+		sound.stream = std::move(stream);
+		return true;
+	}
+
+	bool LoadSound(const std::filesystem::path& path, int sampleRate, SoundData& sound)
+	{
+		Wave wave = LoadWave(path.string().c_str());
+		if (!wave.data || wave.frameCount == 0)
+		{
+			UnloadWave(wave);
+			return false;
+		}
+
+		// Resampled once here, so the callback only ever adds
+		WaveFormat(&wave, sampleRate, 16, 2);
+		const int16_t* samples = static_cast<const int16_t*>(wave.data);
+		sound.name = ToUpper(path.stem().string());
+		sound.frames = wave.frameCount;
+		sound.samples.assign(samples, samples + static_cast<size_t>(wave.frameCount) * 2);
+		UnloadWave(wave);
+		return true;
+	}
+
+}
+#pragma endregion
+
+bool Mixer::Start(const AudioMixerSettings& settings)
+{
+	if (IsActive())
+	{
+		return true;
+	}
+
+	std::error_code error;
+	std::vector<std::filesystem::path> files;
+	for (const auto& entry : std::filesystem::directory_iterator(settings.directory, error))
+	{
+		if (ToUpper(entry.path().extension().string()) == ".WAV")
+		{
+			files.push_back(entry.path());
+		}
+	}
+	if (error)
+	{
+		return false;
+	}
+
+	// Sorted so sound ids don't depend on directory order
+	std::sort(files.begin(), files.end());
+	s_sounds.clear();
+	s_sampleRate = settings.sampleRate;
+	bool anyStreamed = false;
+	for (const std::filesystem::path& file : files)
+	{
+		SoundData sound;
+		const bool streamed = std::filesystem::file_size(file, error) > settings.streamThresholdBytes && OpenStream(file, sound);
+		if (streamed || LoadSound(file, settings.sampleRate, sound))
+		{
+			anyStreamed |= streamed;
+			s_sounds.push_back(std::move(sound));
+		}
+	}
+
+	s_device = settings.openDevice;
+	if (s_device)
+	{
+		InitAudioDevice();
+		if (!IsAudioDeviceReady())
+		{
+			s_sounds.clear();
+			return false;
+		}
+	}
+
+	for (Voice& v : s_voices)
+	{
+		v = Voice{};
+	}
+	s_played = s_stolen = s_dropped = s_underruns = 0;
+
+	if (anyStreamed)
+	{
+		s_streaming.store(true, std::memory_order_release);
+		s_streamer = std::thread(StreamerLoop);
+	}
+
+	// The stream's buffer size sets the callback size, and so the latency
+	if (s_device)
+	{
+		SetAudioStreamBufferSizeDefault(settings.bufferFrames);
+		s_stream = LoadAudioStream(static_cast<unsigned int>(settings.sampleRate), 16, 2);
+		SetAudioStreamCallback(s_stream, MixCallback);
+		PlayAudioStream(s_stream);
+	}
+
+	s_running.store(true, std::memory_order_release);
+	return true;
+}
+
+void Mixer::Stop()
+{
+	if (!IsActive())
+	{
+		return;
+	}
+
+	s_running.store(false, std::memory_order_release);
+	if (s_device)
+	{
+		StopAudioStream(s_stream);
+		UnloadAudioStream(s_stream);
+		CloseAudioDevice();
+	}
+
+	if (s_streamer.joinable())
+	{
+		s_streaming.store(false, std::memory_order_release);
+		s_streamer.join();
+	}
+
+	// The callback is gone, so this thread can drain what it never got to
+	Command command;
+	while (s_queue.TryPop(command))
+	{
+	}
+	s_sounds.clear();
+}
+
+bool Mixer::IsActive()
+{
+	return s_running.load(std::memory_order_acquire);
+}
+
+AudioMixerStats Mixer::GetStats()
+{
+	AudioMixerStats stats;
+	stats.played = s_played.load(std::memory_order_relaxed);
+	stats.stolen = s_stolen.load(std::memory_order_relaxed);
+	stats.dropped = s_dropped.load(std::memory_order_relaxed);
+	stats.underruns = s_underruns.load(std::memory_order_relaxed);
+	return stats;
+}
+
+SoundId Mixer::FindSound(const char* name)
+{
+	if (!IsActive())
+	{
+		return INVALID_SOUND;
+	}
+
+	std::string key = ToUpper(name);
+	if (key.size() > 4 && key.compare(key.size() - 4, 4, ".WAV") == 0)
+	{
+		key.resize(key.size() - 4);
+	}
+	for (size_t i = 0; i < s_sounds.size(); ++i)
+	{
+		if (s_sounds[i].name == key)
+		{
+			return static_cast<SoundId>(i);
+		}
+	}
+	return INVALID_SOUND;
+}
+
+VoiceId Mixer::PlaySound(SoundId sound, bool loop, float volume)
+{
+	if (sound < 0 || !IsActive() || sound >= static_cast<SoundId>(s_sounds.size()))
+	{
+		return INVALID_VOICE;
+	}
+
+	const VoiceId voice = s_nextVoice++;
+	if (s_nextVoice == INVALID_VOICE)
+	{
+		s_nextVoice = 1;
+	}
+
+	Command command;
+	command.type = Command::Type::Play;
+	command.loop = loop;
+	command.gain = static_cast<int32_t>(std::clamp(volume, 0.0f, 4.0f) * (1 << GAIN_SHIFT));
+	command.sound = sound;
+	command.voice = voice;
+	Push(command);
+	return voice;
+}
+
+void Mixer::StopVoice(VoiceId voice)
+{
+	if (voice == INVALID_VOICE || !IsActive())
+	{
+		return;
+	}
+
+	Command command;
+	command.type = Command::Type::StopVoice;
+	command.voice = voice;
+	Push(command);
+}
+
+void Mixer::StopSound(SoundId sound)
+{
+	if (sound < 0 || !IsActive() || sound >= static_cast<SoundId>(s_sounds.size()))
+	{
+		return;
+	}
+
+	Command command;
+	command.type = Command::Type::StopSound;
+	command.sound = sound;
+	Push(command);
+}
+
+void Mixer::Mix(int16_t* out, unsigned int frames)
+{
+	if (!IsActive() || s_device)
+	{
+		std::fill_n(out, frames * 2, static_cast<int16_t>(0));
+		return;
+	}
+	MixFrames(out, frames);
+}
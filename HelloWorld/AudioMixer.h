@@ -0,0 +1,67 @@
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+
+// AudioMixer.h
+// Software mixer for the WAV effects in Data/Audio, played through a single raylib audio stream.
+// - Start decodes every short .wav once to 16-bit stereo at the mixer rate; FindSound turns a name
+//   into an integer id up front, so playing a sound never looks anything up by name
+// - Long tracks (16-bit PCM files over streamThresholdBytes) stay on disk, memory-mapped. A streamer
+//   thread converts them a chunk at a time into two buffers that the callback plays alternately, so
+//   only those two chunks are resident. A streamed sound has one voice: playing it again restarts it
+// - PlaySound/StopVoice/StopSound only push a command into a lock-free SPSC queue: no lock and no
+//   allocation on the game thread
+// - The audio callback drains the queue and mixes a fixed pool of voices into a small buffer. With
+//   the pool full, the oldest one-shot voice is replaced; with the queue full, the command is dropped
+// The game thread is the only producer. Until the mixer is started FindSound returns INVALID_SOUND
+// and every call is a no-op, so headless games (on any thread) never touch the audio device.
+// Started with openDevice off, there is no device and no callback: the caller mixes with Mix instead,
+// which is how the tests check the mixer's output sample by sample.
+
+using SoundId = int;
+using VoiceId = uint32_t;
+constexpr SoundId INVALID_SOUND = -1;
+constexpr VoiceId INVALID_VOICE = 0;
+
+struct AudioMixerSettings
+{
+	std::string directory = "Data/Audio";
+	int sampleRate = 44100;
+	int bufferFrames = 512; // per device callback; ~12 ms at 44.1 kHz
+	size_t streamThresholdBytes = 1 << 20;
+	bool openDevice = true; // false: no audio device, the caller mixes with Mixer::Mix
+};
+
+struct AudioMixerStats
+{
+	uint64_t played = 0;    // voices started by the callback
+	uint64_t stolen = 0;    // voices replaced because the pool was full
+	uint64_t dropped = 0;   // commands lost because the queue was full
+	uint64_t underruns = 0; // callbacks that found the next streamed chunk not ready (played as silence)
+};
+
+namespace Mixer
+{
+	bool Start(const AudioMixerSettings& settings = {});
+
+	// Stops the stream (the callback has returned for good once this does) and frees every sound
+	void Stop();
+
+	bool IsActive();
+	AudioMixerStats GetStats();
+
+	// Case-insensitive, with or without the .wav extension
+	SoundId FindSound(const char* name);
+
+	// volume scales the samples (1 = as recorded, clamped to [0, 4]); looping voices play until stopped
+	VoiceId PlaySound(SoundId sound, bool loop = false, float volume = 1.0f);
+	void StopVoice(VoiceId voice);
+	// Stops every voice playing the sound
+	void StopSound(SoundId sound);
+
+	// Mixes the next `frames` frames of 16-bit stereo into out, exactly as the device callback does.
+	// Only for a mixer started without a device, and then on one thread at a time.
+	void Mix(int16_t* out, unsigned int frames);
+}
@@ -18,6 +18,8 @@ enum class GhostState
     Eaten
 };
 
+constexpr int GHOST_STATE_COUNT = static_cast<int>(GhostState::Eaten) + 1;
+
 // Base class for all ghost state objects.
 class GhostStateBase
 {
@@ -1,19 +1,43 @@
 #include "FSM/GhostStateMachine.h"
 #include "FSM/GhostState.h"
 #include "Ghost.h"
+#include "Trace.h"
 #include <cassert>
 
+#ifdef PACMAN_ENABLE_TRACING
+namespace {
+    const char* GhostTypeName(GhostType type)
+    {
+        switch (type) {
+        case GhostType::BLINKY: return "Blinky";
+        case GhostType::INKY:   return "Inky";
+        case GhostType::PINKY:  return "Pinky";
+        case GhostType::CLYDE:  return "Clyde";
+        }
+        return "Ghost";
+    }
+}
+#endif
+
 GhostStateMachine::GhostStateMachine(Ghost* owner)
     : m_owner(owner), m_currentStateEnum(GhostState::Idle), m_currentStatePtr(nullptr)
 {
     assert(owner && "GhostStateMachine requires a non-null owner");
 }
 
-void GhostStateMachine::AddState(GhostState id, std::unique_ptr<GhostStateBase> state)
+void GhostStateMachine::AddState(GhostState id, GhostStateBase* state)
 {
     assert(state);
-    auto res = m_states.emplace(id, std::move(state));
-    assert(res.second && "AddState: state already registered for this id");
+    GhostStateBase*& slot = m_states[static_cast<int>(id)];
+    assert(!slot && "AddState: state already registered for this id");
+    slot = state;
+}
+
+void GhostStateMachine::Reset()
+{
+    m_currentStateEnum = GhostState::Idle;
+    m_currentStatePtr = nullptr;
+    SetState(GhostState::Idle, nullptr);
 }
 
 void GhostStateMachine::SetState(GhostState newState, IGameBoard* board)
@@ -30,9 +54,10 @@ void GhostStateMachine::SetState(GhostState newState, IGameBoard* board)
     if (m_currentStatePtr) m_currentStatePtr->OnExit(board);
 
     // Look up new state
-    auto it = m_states.find(newState);
+    GhostStateBase* next = m_states[static_cast<int>(newState)];
+    TRACE_INSTANT("fsm", GhostTypeName(m_owner->type), "from", GetCurrentStateName(), "to", next ? next->GetName() : "None");
     m_currentStateEnum = newState;
-    m_currentStatePtr = (it != m_states.end()) ? it->second.get() : nullptr;
+    m_currentStatePtr = next;
 
     // Enter new state if it exists
     if (m_currentStatePtr) m_currentStatePtr->OnEnter(board);
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <map>
-#include <memory>
 #include "FSM/GhostState.h"
 
 class Ghost;
@@ -10,7 +8,7 @@ class IGameBoard;
 
 // GhostStateMachine:
 // - Manages a single ghost's AI states and transitions.
-// - Stores owned state instances and delegates per-frame behavior.
+// - Indexes state instances by enum (owned by the game's arena) and delegates per-frame behavior.
 // - Uses enum + pointer combo for fast access and safe transitions.
 class GhostStateMachine
 {
@@ -22,9 +20,11 @@ public:
     GhostStateMachine(const GhostStateMachine&) = delete;
     GhostStateMachine& operator=(const GhostStateMachine&) = delete;
 
-    // Register a new state with unique ownership
+    // Register a state; the caller keeps ownership and must outlive the FSM
     // Duplicate registration triggers assert
-    void AddState(GhostState id, std::unique_ptr<GhostStateBase> state);
+    void AddState(GhostState id, GhostStateBase* state);
+    // Restart without OnExit on the current state, then enter Idle as a freshly built FSM would
+    void Reset();
     // SetState handles full transition:
     // 1) Guard illegal transitions (e.g., Eaten → Frightened)
     // 2) Skip if already in state
@@ -41,7 +41,7 @@ public:
 
 private:
     Ghost* m_owner;
-    std::map<GhostState, std::unique_ptr<GhostStateBase>> m_states;
+    GhostStateBase* m_states[GHOST_STATE_COUNT] = {};
     GhostState m_currentStateEnum;
     GhostStateBase* m_currentStatePtr;
 };
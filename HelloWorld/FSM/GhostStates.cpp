@@ -4,7 +4,9 @@
 #include "IGameBoard.h"
 #include "Utils.h"
 
-#include <vector>
+#include "AllocTracker.h"
+#include "Arena.h"
+
 #include <random>
 #include <climits>
 #include <cassert>
@@ -32,72 +34,82 @@ namespace {
     // Manhattan distance
     int DistI(int ax, int ay, int bx, int by) { return abs(ax - bx) + abs(ay - by); }
 
-    // Return legal movement directions, avoiding walls and usually avoiding reversal
-    std::vector<Play::Point2f> GetLegalDirs(const IGameBoard* board, int gx, int gy, const Play::Point2f& currDir) {
-        std::vector<Play::Point2f> legal;
-        Play::Point2f rev = OppositeDir(currDir);
-        bool haveNonReverse = false;
-        for (const Play::Point2f& d : DIRS) {
-            int nx = gx + int(d.x), ny = gy + int(d.y);
-            if (!board->IsWall(nx, ny)) {
-                if (!(d.x == rev.x && d.y == rev.y)) { legal.push_back(d); haveNonReverse = true; }
-            }
+    // Centre of the next tile along dir, or of the current tile if that is a wall.
+    // Through a tunnel portal this lies just off the board; Ghost::Update wraps it on arrival.
+    Play::Point2f StepTarget(const IGameBoard* board, int gx, int gy, const Play::Point2f& dir) {
+        int nx, ny;
+        return board->GetNeighbour(gx, gy, dir, nx, ny) ? CenterOf(gx + int(dir.x), gy + int(dir.y)) : CenterOf(gx, gy);
+    }
+
+}
+#pragma endregion
+
+// ----------! Movement decisions !----------
+
+// Return legal movement directions, avoiding walls and usually avoiding reversal.
+// Neighbours come from the board's link table, so tunnel portals count as open.
+DirList GetLegalDirs(const IGameBoard* board, int gx, int gy, const Play::Point2f& currDir) {
+    ALLOC_SCOPE(AllocPhase::GetLegalDirs);
+    DirList legal;
+    Play::Point2f rev = OppositeDir(currDir);
+    bool haveNonReverse = false;
+    int nx, ny;
+    for (const Play::Point2f& d : DIRS) {
+        if (board->GetNeighbour(gx, gy, d, nx, ny)) {
+            if (!(d.x == rev.x && d.y == rev.y)) { legal.push_back(d); haveNonReverse = true; }
         }
-        if (!haveNonReverse) {
-            for (const Play::Point2f& d : DIRS) {
-                int nx = gx + int(d.x), ny = gy + int(d.y);
-                if (!board->IsWall(nx, ny)) legal.push_back(d);
-            }
+    }
+    if (!haveNonReverse) {
+        for (const Play::Point2f& d : DIRS) {
+            if (board->GetNeighbour(gx, gy, d, nx, ny)) legal.push_back(d);
         }
-        return legal;
     }
+    return legal;
+}
+
+// Choose direction that minimizes distance to target, using arcade tie-breaking
+Play::Point2f ChooseBestDir(int gx, int gy, int tx, int ty, const DirList& candidates, std::mt19937& rng)
+{
+    ALLOC_SCOPE(AllocPhase::ChooseBestDir);
+    if (candidates.empty()) return Play::Point2f{0,0};
+
+    auto priorityIndex = [](const Play::Point2f& d)->int {
+        if (d.x == 0 && d.y == -1) return 0; // up
+        if (d.x == -1 && d.y == 0) return 1; // left
+        if (d.x == 0 && d.y == 1) return 2;  // down
+        return 3; // right
+    };
+
+    int bestScore = INT_MAX;
+    int bestPriority = INT_MAX;
+    DirList bests;
 
-    // Choose direction that minimizes distance to target, using arcade tie-breaking
-    Play::Point2f ChooseBestDir(int gx, int gy, int tx, int ty, const std::vector<Play::Point2f>& candidates)
-    {
-        if (candidates.empty()) return Play::Point2f{0,0};
-
-        auto priorityIndex = [](const Play::Point2f& d)->int {
-            if (d.x == 0 && d.y == -1) return 0; // up
-            if (d.x == -1 && d.y == 0) return 1; // left
-            if (d.x == 0 && d.y == 1) return 2;  // down
-            return 3; // right
-        };
-
-        int bestScore = INT_MAX;
-        int bestPriority = INT_MAX;
-        std::vector<Play::Point2f> bests;
-
-        for (const auto &d : candidates) {
-            int nx = gx + int(d.x), ny = gy + int(d.y);
-            int score = DistI(nx, ny, tx, ty);
-            int pr = priorityIndex(d);
-            if (score < bestScore) {
-                bestScore = score;
+    for (const auto &d : candidates) {
+        int nx = gx + int(d.x), ny = gy + int(d.y);
+        int score = DistI(nx, ny, tx, ty);
+        int pr = priorityIndex(d);
+        if (score < bestScore) {
+            bestScore = score;
+            bestPriority = pr;
+            bests.clear();
+            bests.push_back(d);
+        } else if (score == bestScore) {
+            if (pr < bestPriority) {
                 bestPriority = pr;
                 bests.clear();
                 bests.push_back(d);
-            } else if (score == bestScore) {
-                if (pr < bestPriority) {
-                    bestPriority = pr;
-                    bests.clear();
-                    bests.push_back(d);
-                } else if (pr == bestPriority) {
-                    bests.push_back(d);
-                }
+            } else if (pr == bestPriority) {
+                bests.push_back(d);
             }
         }
-
-        if (bests.size() == 1) return bests[0];
-
-        // Randomly pick among equal candidates to reduce mechanical oscillation
-        thread_local std::mt19937 rng{ std::random_device{}() };
-        std::uniform_int_distribution<int> dist(0, static_cast<int>(bests.size()) - 1);
-        return bests[dist(rng)];
     }
 
+    if (bests.size() == 1) return bests[0];
+
+    // Randomly pick among equal candidates to reduce mechanical oscillation
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(bests.size()) - 1);
+    return bests[dist(rng)];
 }
-#pragma endregion
 
 // ----------! Concrete states !----------
 
@@ -131,9 +143,8 @@ public:
         auto corner = board->GetScatterTarget(m_owner->type);
         int tx = corner.x, ty = corner.y;
         auto legal = GetLegalDirs(board, cgx, cgy, m_owner->dir);
-        m_owner->dir = ChooseBestDir(cgx, cgy, tx, ty, legal);
-        int ntx = cgx + int(m_owner->dir.x), nty = cgy + int(m_owner->dir.y);
-        m_owner->target = !board->IsWall(ntx, nty) ? CenterOf(ntx, nty) : CenterOf(cgx, cgy);
+        m_owner->dir = ChooseBestDir(cgx, cgy, tx, ty, legal, board->GetRng());
+        m_owner->target = StepTarget(board, cgx, cgy, m_owner->dir);
     }
     GhostState GetStateId() const override { return GhostState::Scatter; }
     const char* GetName() const override { return "Scatter"; }
@@ -180,9 +191,8 @@ public:
         }
 
         auto legal = GetLegalDirs(board, cgx, cgy, m_owner->dir);
-        m_owner->dir = ChooseBestDir(cgx, cgy, tx, ty, legal);
-        int ntx = cgx + int(m_owner->dir.x), nty = cgy + int(m_owner->dir.y);
-        m_owner->target = !board->IsWall(ntx, nty) ? CenterOf(ntx, nty) : CenterOf(cgx, cgy);
+        m_owner->dir = ChooseBestDir(cgx, cgy, tx, ty, legal, board->GetRng());
+        m_owner->target = StepTarget(board, cgx, cgy, m_owner->dir);
     }
     GhostState GetStateId() const override { return GhostState::Chase; }
     const char* GetName() const override { return "Chase"; }
@@ -207,11 +217,9 @@ public:
         int cgx = m_owner->gx, cgy = m_owner->gy;
         auto legal = GetLegalDirs(board, cgx, cgy, m_owner->dir);
         if (legal.empty()) return;
-        static thread_local std::mt19937 rng{ std::random_device{}() };
         std::uniform_int_distribution<int> dist(0, static_cast<int>(legal.size()) - 1);
-        m_owner->dir = legal[dist(rng)];
-        int ntx = cgx + int(m_owner->dir.x), nty = cgy + int(m_owner->dir.y);
-        m_owner->target = !board->IsWall(ntx, nty) ? CenterOf(ntx, nty) : CenterOf(cgx, cgy);
+        m_owner->dir = legal[dist(board->GetRng())];
+        m_owner->target = StepTarget(board, cgx, cgy, m_owner->dir);
     }
     GhostState GetStateId() const override { return GhostState::Frightened; }
     const char* GetName() const override { return "Frightened"; }
@@ -231,9 +239,8 @@ public:
         int cgx = m_owner->gx, cgy = m_owner->gy;
         int tx = m_owner->spawnGX, ty = m_owner->spawnGY;
         auto legal = GetLegalDirs(board, cgx, cgy, m_owner->dir);
-        m_owner->dir = ChooseBestDir(cgx, cgy, tx, ty, legal);
-        int ntx = cgx + int(m_owner->dir.x), nty = cgy + int(m_owner->dir.y);
-        m_owner->target = !board->IsWall(ntx, nty) ? CenterOf(ntx, nty) : CenterOf(cgx, cgy);
+        m_owner->dir = ChooseBestDir(cgx, cgy, tx, ty, legal, board->GetRng());
+        m_owner->target = StepTarget(board, cgx, cgy, m_owner->dir);
 
         int curGX = int(m_owner->pos.x) / Cfg::TILE_SIZE;
         int curGY = int(m_owner->pos.y) / Cfg::TILE_SIZE;
@@ -246,9 +253,9 @@ public:
 };
 
 // Factory implementations
-std::unique_ptr<GhostStateBase> MakeIdleState(Ghost* owner) { return std::make_unique<IdleState>(owner); }
-std::unique_ptr<GhostStateBase> MakeScatterState(Ghost* owner) { return std::make_unique<ScatterState>(owner); }
-std::unique_ptr<GhostStateBase> MakeChaseState(Ghost* owner) { return std::make_unique<ChaseState>(owner); }
-std::unique_ptr<GhostStateBase> MakeFrightenedState(Ghost* owner) { return std::make_unique<FrightenedState>(owner); }
-std::unique_ptr<GhostStateBase> MakeEatenState(Ghost* owner) { return std::make_unique<EatenState>(owner); }
+GhostStateBase* MakeIdleState(Arena& arena, Ghost* owner) { return arena.Create<IdleState>(owner); }
+GhostStateBase* MakeScatterState(Arena& arena, Ghost* owner) { return arena.Create<ScatterState>(owner); }
+GhostStateBase* MakeChaseState(Arena& arena, Ghost* owner) { return arena.Create<ChaseState>(owner); }
+GhostStateBase* MakeFrightenedState(Arena& arena, Ghost* owner) { return arena.Create<FrightenedState>(owner); }
+GhostStateBase* MakeEatenState(Arena& arena, Ghost* owner) { return arena.Create<EatenState>(owner); }
 
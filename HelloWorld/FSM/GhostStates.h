@@ -1,12 +1,38 @@
 #pragma once
-#include <memory>
+#include <random>
+
 #include "FSM/GhostState.h"
+#include "Utils.h"
 
+class Arena;
 class Ghost;
+class IGameBoard;
+
+// Factory functions construct concrete states in `arena`, which owns them.
+GhostStateBase* MakeIdleState(Arena& arena, Ghost* owner);
+GhostStateBase* MakeScatterState(Arena& arena, Ghost* owner);
+GhostStateBase* MakeChaseState(Arena& arena, Ghost* owner);
+GhostStateBase* MakeFrightenedState(Arena& arena, Ghost* owner);
+GhostStateBase* MakeEatenState(Arena& arena, Ghost* owner);
+
+// Up to four directions stored inline, so move decisions never touch the heap.
+// Keeps the std container names the states already use (empty, size, operator[], range-for).
+struct DirList
+{
+    Play::Point2f dirs[4];
+    int count = 0;
+
+    void push_back(const Play::Point2f& d) { dirs[count++] = d; }
+    void clear() { count = 0; }
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+    const Play::Point2f& operator[](int i) const { return dirs[i]; }
+    const Play::Point2f* begin() const { return dirs; }
+    const Play::Point2f* end() const { return dirs + count; }
+};
 
-// Factory functions produce unique_ptrs to concrete states.
-std::unique_ptr<GhostStateBase> MakeIdleState(Ghost* owner);
-std::unique_ptr<GhostStateBase> MakeScatterState(Ghost* owner);
-std::unique_ptr<GhostStateBase> MakeChaseState(Ghost* owner);
-std::unique_ptr<GhostStateBase> MakeFrightenedState(Ghost* owner);
-std::unique_ptr<GhostStateBase> MakeEatenState(Ghost* owner);
+// Movement decisions shared by the states (exposed for the benchmarks).
+// GetLegalDirs: open neighbours of (gx, gy), leaving out the reverse of currDir unless it is the only way out.
+DirList GetLegalDirs(const IGameBoard* board, int gx, int gy, const Play::Point2f& currDir);
+// ChooseBestDir: candidate whose next tile is nearest the target, ties broken up > left > down > right, then by rng.
+Play::Point2f ChooseBestDir(int gx, int gy, int tx, int ty, const DirList& candidates, std::mt19937& rng);
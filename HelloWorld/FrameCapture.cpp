@@ -0,0 +1,255 @@
+// This file's header
+#include "FrameCapture.h"
+
+// Other includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Utils.h"
+#include "SpscQueue.h"
+#include "TextureReadback.h"
+
+#pragma region Helpers
+namespace {
+
+	struct CapturedFrame
+	{
+		uint8_t* pixels = nullptr; // one of s_buffers, returned through s_free once written
+		int width = 0, height = 0;
+		uint32_t index = 0;
+	};
+
+	// A few frames of slack for slow disks; beyond that, frames are dropped. One buffer per queue slot,
+	// so a frame that has a buffer always has room in the queue
+	constexpr size_t QUEUE_DEPTH = 8;
+
+	FrameCaptureSettings s_settings;
+	SpscQueue<CapturedFrame, QUEUE_DEPTH> s_queue; // game thread -> encoder
+	SpscQueue<uint8_t*, QUEUE_DEPTH> s_free;       // encoder -> game thread
+	std::unique_ptr<uint8_t[]> s_buffers[QUEUE_DEPTH];
+	std::thread s_encoder;
+	std::atomic<bool> s_running{ false };
+	std::atomic<uint64_t> s_captured{ 0 }, s_written{ 0 }, s_dropped{ 0 };
+
+	// Game thread only
+	RenderTexture2D s_staging[2]{};
+	bool s_stagingLoaded = false;
+	int s_current = 0;        // staging texture the next copy goes into
+	bool s_pending = false;   // the other staging texture holds a copy not yet read back
+	uint32_t s_presented = 0; // frames seen by the hook
+	uint32_t s_nextIndex = 0; // file number of the next queued frame
+	uint8_t* s_spare = nullptr; // a buffer taken from s_free but not sent
+
+	// Encoder thread: GL rows are bottom-up, so flip in place before writing
+	void WriteFrame(const CapturedFrame& frame, std::vector<uint8_t>& row)
+	{
+		const size_t pitch = static_cast<size_t>(frame.width) * 4;
+		row.resize(pitch);
+		for (int y = 0; y < frame.height / 2; ++y)
+		{
+			uint8_t* top = frame.pixels + y * pitch;
+			uint8_t* bottom = frame.pixels + (frame.height - 1 - y) * pitch;
+			std::memcpy(row.data(), top, pitch);
+			std::memcpy(top, bottom, pitch);
+			std::memcpy(bottom, row.data(), pitch);
+		}
+
+		char path[512];
+		std::snprintf(path, sizeof(path), "%s/frame_%06u.png", s_settings.directory.c_str(), frame.index);
+		const Image image{ frame.pixels, frame.width, frame.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+		if (ExportImage(image, path))
+		{
+			s_written.fetch_add(1, std::memory_order_relaxed);
+		}
+		s_free.TryPush(frame.pixels);
+	}
+
+	void EncoderLoop()
+	{
+		std::vector<uint8_t> row;
+		CapturedFrame frame;
+		for (;;)
+		{
+			if (s_queue.TryPop(frame))
+			{
+				WriteFrame(frame, row);
+				continue;
+			}
+
+			if (!s_running.load(std::memory_order_acquire))
+			{
+				// Everything pushed before the stop is visible now
+				while (s_queue.TryPop(frame))
+				{
+					WriteFrame(frame, row);
+				}
+				return;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+
+	// Reads back a staging texture into a free buffer and queues it; `wait` blocks for a buffer instead of dropping
+	void QueueReadback(const RenderTexture2D& staging, bool wait)
+	{
+		// Check first so a frame with nowhere to go does not pay for the readback either
+		uint8_t* pixels = std::exchange(s_spare, nullptr);
+		while (!pixels && !s_free.TryPop(pixels))
+		{
+			if (!wait)
+			{
+				s_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			std::this_thread::yield();
+		}
+
+		const Texture2D& texture = staging.texture;
+		if (!ReadTextureRgba8(texture.id, texture.width, texture.height, pixels))
+		{
+			s_spare = pixels; // only the encoder may push to s_free
+			return;
+		}
+
+		CapturedFrame frame;
+		frame.pixels = pixels;
+		frame.width = texture.width;
+		frame.height = texture.height;
+		frame.index = s_nextIndex++;
+
+		// Never full: there are only as many buffers as queue slots
+		s_queue.TryPush(frame);
+		s_captured.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void OnPresent(const RenderTexture2D& frame)
+	{
+		if (s_presented++ % static_cast<uint32_t>(s_settings.frameStep) != 0)
+		{
+			return;
+		}
+
+		const int w = frame.texture.width, h = frame.texture.height;
+		if (!s_stagingLoaded)
+		{
+			s_staging[0] = LoadRenderTexture(w, h);
+			s_staging[1] = LoadRenderTexture(w, h);
+			s_stagingLoaded = true;
+
+			// Sized from the first frame, once. The encoder only pushes buffers it was sent, so until then
+			// this thread is the free queue's only producer
+			for (std::unique_ptr<uint8_t[]>& buffer : s_buffers)
+			{
+				buffer = std::make_unique<uint8_t[]>(static_cast<size_t>(w) * h * 4);
+				s_free.TryPush(buffer.get());
+			}
+		}
+
+		// 1) GPU-side copy of this frame; nothing waits on it yet. The negative height keeps the copy's rows
+		// in the frame's bottom-up order (as PresentDrawingBuffer does on screen), so WriteFrame's flip is the only one
+		BeginTextureMode(s_staging[s_current]);
+		DrawTextureRec(frame.texture, { 0, 0, static_cast<float>(w), -static_cast<float>(h) }, { 0, 0 }, WHITE);
+		EndTextureMode();
+
+		// 2) Read back the copy made on the previous capture. The GPU has usually finished it, so the wait is
+		// shorter than for this frame's copy, but the readback still blocks until it has
+		if (s_pending)
+		{
+			QueueReadback(s_staging[s_current ^ 1], false);
+		}
+
+		s_pending = true;
+		s_current ^= 1;
+	}
+
+}
+#pragma endregion
+
+bool StartFrameCapture(const FrameCaptureSettings& settings)
+{
+	if (IsFrameCaptureActive())
+	{
+		return true;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(settings.directory, error);
+	if (error)
+	{
+		return false;
+	}
+
+	s_settings = settings;
+	s_settings.frameStep = std::max(settings.frameStep, 1);
+	s_captured = s_written = s_dropped = 0;
+	s_current = 0;
+	s_pending = false;
+	s_presented = 0;
+	s_nextIndex = 0;
+
+	s_running.store(true, std::memory_order_release);
+	s_encoder = std::thread(EncoderLoop);
+	Play::SetPresentHook(OnPresent);
+	return true;
+}
+
+void StopFrameCapture()
+{
+	if (!IsFrameCaptureActive())
+	{
+		return;
+	}
+
+	Play::SetPresentHook(nullptr);
+
+	// The most recent copy has not been read back yet; keep it rather than ending one frame short
+	if (s_pending)
+	{
+		QueueReadback(s_staging[s_current ^ 1], true);
+		s_pending = false;
+	}
+
+	s_running.store(false, std::memory_order_release);
+	s_encoder.join();
+
+	if (s_stagingLoaded)
+	{
+		UnloadRenderTexture(s_staging[0]);
+		UnloadRenderTexture(s_staging[1]);
+		s_stagingLoaded = false;
+	}
+
+	// Every buffer is back in the free queue now the encoder has written them all
+	uint8_t* pixels;
+	while (s_free.TryPop(pixels))
+	{
+	}
+	s_spare = nullptr;
+	for (std::unique_ptr<uint8_t[]>& buffer : s_buffers)
+	{
+		buffer.reset();
+	}
+}
+
+bool IsFrameCaptureActive()
+{
+	return s_running.load(std::memory_order_acquire);
+}
+
+FrameCaptureStats GetFrameCaptureStats()
+{
+	FrameCaptureStats stats;
+	stats.captured = s_captured.load(std::memory_order_relaxed);
+	stats.written = s_written.load(std::memory_order_relaxed);
+	stats.dropped = s_dropped.load(std::memory_order_relaxed);
+	return stats;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+
+// FrameCapture.h
+// Records presented frames as a numbered PNG sequence (frame_000000.png, ...), keeping the game loop's share small.
+// - Each captured frame is copied on the GPU into one of two capture textures, and the copy made on the
+//   previous capture is read back. The GPU has usually finished that one, which reduces the stall, but the
+//   readback is still synchronous on the game thread
+// - Frames are read into a fixed pool of buffers that go to an encoder thread through a lock-free queue and
+//   come back through another, so capturing allocates nothing per frame
+// - When encoding falls behind and no buffer is free, frames are dropped (and counted) instead of blocking the game
+// Hooks into Play::PresentDrawingBuffer; needs a window, so Start after Play::CreateManager and
+// Stop before Play::DestroyManager.
+struct FrameCaptureSettings
+{
+	std::string directory = "capture"; // created if missing
+	int frameStep = 1;                  // capture every Nth presented frame
+};
+
+struct FrameCaptureStats
+{
+	uint64_t captured = 0; // read back and queued
+	uint64_t written = 0;  // encoded to disk
+	uint64_t dropped = 0;  // skipped because every buffer was still with the encoder
+};
+
+bool StartFrameCapture(const FrameCaptureSettings& settings = {});
+
+// Flushes the last copied frame, waits for the encoder to drain, then releases the capture textures and buffers
+void StopFrameCapture();
+
+bool IsFrameCaptureActive();
+FrameCaptureStats GetFrameCaptureStats();
@@ -4,22 +4,36 @@
 // Other includes
 #include "Ghost.h"
 #include "Pacman.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <cassert>
 #include <random>
 
 Game::Game()
 {
-	pac = std::make_unique<Pacman>();
+	// Built once; Init only re-places and resets them, so replaying a game never touches the heap
+	pac = arena.Create<Pacman>();
 
-	ghosts.resize(4);
-	for (int i = 0; i <= 3; ++i)
+	for (Ghost*& g : ghosts)
 	{
-		ghosts[i] = std::make_unique<Ghost>();
+		g = arena.Create<Ghost>();
+		g->InitStateMachine(arena);
 	}
+
+	assert(!arena.HasOverflowed() && "Game: ARENA_BYTES too small for the actors");
+}
+
+Game::~Game()
+{
+	Play::DestroyLayer(wallLayer);
+	Play::DestroyLayer(pelletLayer);
 }
 
-bool Game::InBounds(int x, int y)
+bool Game::InBounds(int x, int y) const
 {
-	return x >= 0 && y >= 0 && x < Cfg::GRID_WIDTH && y < Cfg::GRID_HEIGHT;
+	return maze.InBounds(x, y);
 }
 
 bool Game::IsWall(int x, int y) const
@@ -32,14 +46,37 @@ bool Game::IsWall(int x, int y) const
 	return maze[y][x] == TileType::WALL;
 }
 
+bool Game::GetNeighbour(int x, int y, const Play::Point2f& dir, int& nx, int& ny) const
+{
+	const int32_t next = maze.LinksAt(x, y).next[Maze::DirIndex(int(dir.x), int(dir.y))];
+	nx = next & 0xFFFF;
+	ny = next >> 16;
+	return next != Maze::NO_LINK;
+}
+
+float Game::GetGhostSpeedMult(int x, int y) const
+{
+	return maze.LinksAt(x, y).ghostSpeedMult;
+}
+
+Play::Point2f Game::WrapPosition(const Play::Point2f& pos) const
+{
+	const float w = static_cast<float>(maze.width * Cfg::TILE_SIZE);
+	const float h = static_cast<float>(maze.height * Cfg::TILE_SIZE);
+	Play::Point2f p = pos;
+	if (p.x < 0.0f) p.x += w; else if (p.x >= w) p.x -= w;
+	if (p.y < 0.0f) p.y += h; else if (p.y >= h) p.y -= h;
+	return p;
+}
+
 Play::Point2f Game::GetScatterTarget(GhostType type) const
 {
 	switch (type)
 	{
-	case GhostType::BLINKY: return { Cfg::GRID_WIDTH - 2, 1 };                 // top-right
-	case GhostType::PINKY:  return { 1, 1 };                                   // top-left
-	case GhostType::INKY:   return { Cfg::GRID_WIDTH - 2, Cfg::GRID_HEIGHT-2 };// bottom-right
-	case GhostType::CLYDE:  return { 1, Cfg::GRID_HEIGHT - 2 };                // bottom-left
+	case GhostType::BLINKY: return { maze.width - 2, 1 };                  // top-right
+	case GhostType::PINKY:  return { 1, 1 };                               // top-left
+	case GhostType::INKY:   return { maze.width - 2, maze.height - 2 };    // bottom-right
+	case GhostType::CLYDE:  return { 1, maze.height - 2 };                 // bottom-left
 	}
 	return {0,0};
 }
@@ -56,7 +93,7 @@ Play::Point2f Game::GetPacPosition() const
 
 Play::Point2f Game::GetGhostGrid(GhostType type) const
 {
-	for (const std::unique_ptr<Ghost>& g : ghosts)
+	for (Ghost* g : ghosts)
 	{
 		if (g->type == type)
 		{
@@ -68,49 +105,59 @@ Play::Point2f Game::GetGhostGrid(GhostType type) const
 
 void Game::BuildArena()
 {
-	for (int y = 0; y < Cfg::GRID_HEIGHT; ++y)
+	maze.Resize(Cfg::GRID_WIDTH, Cfg::GRID_HEIGHT, TileType::PELLET);
+	for (int y = 0; y < maze.height; ++y)
 	{
-		for (int x = 0; x < Cfg::GRID_WIDTH; ++x)
+		for (int x = 0; x < maze.width; ++x)
 		{
-			const bool border = (x == 0 || y == 0 || x == Cfg::GRID_WIDTH - 1 || y == Cfg::GRID_HEIGHT - 1);
+			const bool border = (x == 0 || y == 0 || x == maze.width - 1 || y == maze.height - 1);
 			maze[y][x] = border ? TileType::WALL : TileType::PELLET;
 		}
 	}
+
+	// Side tunnel through the middle row: portal on each border plus a short slow-down zone
+	const int ty = maze.height / 2;
+	for (int x = 0; x < 3; ++x)
+	{
+		maze[ty][x] = TileType::TUNNEL;
+		maze[ty][maze.width - 1 - x] = TileType::TUNNEL;
+	}
+	maze.BuildLinks();
+
+	// Player start
+	maze.pacSpawnX = 13 - 4;
+	maze.pacSpawnY = 23;
 }
 
 void Game::SpawnPowerUp()
 {
-	// Gather all tiles that currently contain a pellet
-	std::vector<Play::Point2f> candidates;
-	for (int y = 0; y < Cfg::GRID_HEIGHT; ++y)
+	ALLOC_SCOPE(AllocPhase::SpawnPowerUp);
+
+	// Pick the n-th pellet tile uniformly; pelletsRemaining already counts them, so no candidate list is needed
+	if (pelletsRemaining <= 0)
 	{
-		for (int x = 0; x < Cfg::GRID_WIDTH; ++x)
-		{
-			if (maze[y][x] == TileType::PELLET)
-			{
-				candidates.emplace_back( x, y );
-			}
-		}
+		return;
 	}
 
-	if (!candidates.empty())
+	std::uniform_int_distribution<int> dist(0, pelletsRemaining - 1);
+	int n = dist(rng);
+	for (size_t i = 0; i < maze.tiles.size(); ++i)
 	{
-		static std::random_device rd;
-		static std::mt19937 rand(rd());
-		std::uniform_int_distribution<int> dist(0, static_cast<int>(candidates.size()) - 1);
-
-		const int idx = dist(rand);
-		const Play::Point2f choice = candidates[idx];
-		maze[static_cast<int>(choice.y)][static_cast<int>(choice.x)] = TileType::POWERUP;
-		powerUpPresent = true;
+		if (maze.tiles[i] == TileType::PELLET && n-- == 0)
+		{
+			SetTile(static_cast<int>(i % maze.width), static_cast<int>(i / maze.width), TileType::POWERUP);
+			powerUpPresent = true;
+			return;
+		}
 	}
 }
 
 void Game::ActivatePowerUp()
 {
+	TRACE_INSTANT("game", "PowerUp");
 	powerUpTimer = Cfg::POWERUP_DURATION;
 	powerUpPresent = false;
-	for (const std::unique_ptr<Ghost>& g : ghosts)
+	for (Ghost* g : ghosts)
 	{
 		g->EnterFrightened(this);
 	}
@@ -118,44 +165,177 @@ void Game::ActivatePowerUp()
 
 void Game::Init()
 {
+	collectSound = Mixer::FindSound("snd_collect");
 	BuildArena();
+	ResetTileTracking();
+	BuildMazeLayers();
+	InitActors();
+}
+
+void Game::Init(const Maze& layout)
+{
+	collectSound = Mixer::FindSound("snd_collect");
+	maze = layout;
+	maze.BuildLinks();
+	ResetTileTracking();
+	BuildMazeLayers();
+	InitActors();
+}
 
+void Game::InitActors()
+{
 	// Player start
-	pac->Init(13 - 4, 23);
+	pac->Init(maze.pacSpawnX, maze.pacSpawnY);
 
 	// Ghosts
-	constexpr int cx = Cfg::GRID_WIDTH / 2;
-	constexpr int cy = Cfg::GRID_HEIGHT / 2;
+	const int cx = maze.width / 2;
+	const int cy = maze.height / 2;
 	ghosts[0]->Init(GhostType::BLINKY, cx - 2, cy, Play::cRed);
 	ghosts[1]->Init(GhostType::INKY, cx, cy, Play::cCyan);
 	ghosts[2]->Init(GhostType::PINKY, cx + 2, cy, Play::cMagenta);
 	ghosts[3]->Init(GhostType::CLYDE, cx, cy + 2, Play::cOrange);
 
+	// Round state
+	powerUpTimer = 0.0f;
+	powerUpPresent = false;
+	globalMode = GlobalMode::Scatter;
+	modeTimer = Cfg::SCATTER_DURATION;
+	gameStarted = false;
+	livesLost = 0;
+
 	SpawnPowerUp();
 }
 
-void Game::DrawMaze() const
+void Game::SetTile(int x, int y, TileType type)
 {
-	for (int y = 0; y < Cfg::GRID_HEIGHT; ++y)
+	TileType& tile = maze[y][x];
+	pelletsRemaining += (type == TileType::PELLET) - (tile == TileType::PELLET);
+	tile = type;
+
+	const int idx = y * maze.width + x;
+	if (!dirtyMask[idx])
 	{
-		for (int x = 0; x < Cfg::GRID_WIDTH; ++x)
+		dirtyMask[idx] = 1;
+		dirtyTiles.push_back(idx);
+	}
+}
+
+void Game::ResetTileTracking()
+{
+	pelletsRemaining = static_cast<int>(std::count(maze.tiles.begin(), maze.tiles.end(), TileType::PELLET));
+	dirtyTiles.clear();
+	dirtyTiles.reserve(maze.tiles.size()); // every tile at most once, so SetTile never reallocates mid-game
+	dirtyMask.assign(maze.tiles.size(), 0);
+}
+
+void Game::BuildMazeLayers()
+{
+	// Creation fails without a window (headless runs); DrawMaze then draws immediately
+	const int w = maze.width * Cfg::TILE_SIZE, h = maze.height * Cfg::TILE_SIZE;
+	if (Play::CreateLayer(wallLayer, w, h))
+	{
+		Play::BeginLayer(wallLayer);
+		DrawWalls();
+		Play::EndLayer();
+	}
+
+	if (Play::CreateLayer(pelletLayer, w, h))
+	{
+		Play::BeginLayer(pelletLayer);
+		for (int y = 0; y < maze.height; ++y)
+		{
+			for (int x = 0; x < maze.width; ++x)
+			{
+				DrawPellet(x, y);
+			}
+		}
+		Play::EndLayer();
+	}
+}
+
+void Game::DrawWalls() const
+{
+	for (int y = 0; y < maze.height; ++y)
+	{
+		for (int x = 0; x < maze.width; ++x)
 		{
-			int px = x * Cfg::TILE_SIZE, py = y * Cfg::TILE_SIZE;
 			if (maze[y][x] == TileType::WALL)
 			{
+				int px = x * Cfg::TILE_SIZE, py = y * Cfg::TILE_SIZE;
 				Play::DrawRect({ px, py }, { px + Cfg::TILE_SIZE - 1, py + Cfg::TILE_SIZE - 1 }, Play::cBlue, true);
-			}				
-			else if (maze[y][x] == TileType::PELLET)
-			{
-				Play::DrawCircle({ px + Cfg::TILE_SIZE / 2, py + Cfg::TILE_SIZE / 2 }, Cfg::PELLET_RADIUS, Play::cWhite);
 			}
-			else if (maze[y][x] == TileType::POWERUP)
+		}
+	}
+}
+
+void Game::DrawPellet(int x, int y) const
+{
+	const int px = x * Cfg::TILE_SIZE, py = y * Cfg::TILE_SIZE;
+	if (maze[y][x] == TileType::PELLET)
+	{
+		Play::DrawCircle({ px + Cfg::TILE_SIZE / 2, py + Cfg::TILE_SIZE / 2 }, Cfg::PELLET_RADIUS, Play::cWhite);
+	}
+	else if (maze[y][x] == TileType::POWERUP)
+	{
+		Play::DrawCircle({ px + Cfg::TILE_SIZE / 2, py + Cfg::TILE_SIZE / 2 }, Cfg::POWERUP_RADIUS, Play::cYellow);
+	}
+}
+
+void Game::FlushDirtyTiles()
+{
+	if (dirtyTiles.empty())
+	{
+		return;
+	}
+
+	// Without the layer DrawMaze redraws every pellet anyway, so the list is just cleared
+	if (Play::IsLayerValid(pelletLayer))
+	{
+		Play::BeginLayer(pelletLayer);
+		for (int idx : dirtyTiles)
+		{
+			const int x = idx % maze.width, y = idx / maze.width;
+			const int px = x * Cfg::TILE_SIZE, py = y * Cfg::TILE_SIZE;
+			Play::ClearRect({ px, py }, { px + Cfg::TILE_SIZE - 1, py + Cfg::TILE_SIZE - 1 }, Play::cTransparent);
+			DrawPellet(x, y);
+		}
+		Play::EndLayer();
+	}
+
+	for (int idx : dirtyTiles)
+	{
+		dirtyMask[idx] = 0;
+	}
+	dirtyTiles.clear();
+}
+
+void Game::DrawMaze() const
+{
+	// Walls never change during play, so blit the cached layer when there is one
+	if (Play::IsLayerValid(wallLayer))
+	{
+		Play::DrawLayer(wallLayer, { 0, 0 });
+	}
+	else
+	{
+		DrawWalls();
+	}
+
+	// Up to date as of the last FlushDirtyTiles
+	if (Play::IsLayerValid(pelletLayer))
+	{
+		Play::DrawLayer(pelletLayer, { 0, 0 });
+	}
+	else
+	{
+		for (int y = 0; y < maze.height; ++y)
+		{
+			for (int x = 0; x < maze.width; ++x)
 			{
-				Play::DrawCircle({ px + Cfg::TILE_SIZE / 2, py + Cfg::TILE_SIZE / 2 }, Cfg::POWERUP_RADIUS, Play::cYellow);
+				DrawPellet(x, y);
 			}
 		}
 	}
-
 }
 
 void Game::Update(float dt)
@@ -169,6 +349,7 @@ void Game::Update(float dt)
 
 	if (powerUpTimer <= 0.0f)
 	{
+		PROFILE_SCOPE(ProfPhase::ModeTimer);
 		modeTimer -= dt;
 		if (modeTimer <= 0.0f)
 		{
@@ -180,22 +361,27 @@ void Game::Update(float dt)
 				globalMode = GlobalMode::Scatter;
 				modeTimer = Cfg::SCATTER_DURATION;
 			}
-			for (const std::unique_ptr<Ghost>& g : ghosts) {
+			TRACE_INSTANT("game", "ModeFlip", "mode", globalMode == GlobalMode::Chase ? "Chase" : "Scatter");
+			for (Ghost* g : ghosts) {
 				g->OnGlobalModeChange(this, globalMode);
 			}
 		}
 	}
 
-	pac->HandleInput();
-	pac->Update(this, dt);
+	{
+		PROFILE_SCOPE(ProfPhase::Pacman);
+		pac->HandleInput();
+		pac->Update(this, dt);
+	}
 
 	if (powerUpTimer > 0.0f)
 	{
+		PROFILE_SCOPE(ProfPhase::PowerUp);
 		powerUpTimer -= dt;
 		if (powerUpTimer <= 0.0f)
 		{
 			powerUpTimer = 0.0f;
-			for (const std::unique_ptr<Ghost>& g : ghosts)
+			for (Ghost* g : ghosts)
 			{
 				g->ExitFrightened(this);
 			}				
@@ -204,36 +390,39 @@ void Game::Update(float dt)
 	else if (!powerUpPresent)
 	{
 		// Power-up expired and none present on the board
+		PROFILE_SCOPE(ProfPhase::PowerUp);
 		SpawnPowerUp();
 	}
 
-	for (const std::unique_ptr<Ghost>& g : ghosts)
+	// Ghost::Update times its own FSM, movement and collision test
+	for (Ghost* g : ghosts)
 	{
 		bool collidedWithPac = g->Update(this, pac->gx, pac->gy, dt);
 
 		// Handle collision with Pacman if detected
 		if (collidedWithPac)
 		{
+			PROFILE_SCOPE(ProfPhase::Collision);
 			if (g->GetState() == GhostState::Frightened)
 			{
 				g->SetEaten(this);
 			}
 			else if (g->GetState() != GhostState::Eaten)
 			{
+				++livesLost;
 				pac->ResetToSpawn();
-				for (const std::unique_ptr<Ghost>& ghost : ghosts)
+				for (Ghost* ghost : ghosts)
 					ghost->ResetToSpawn();
 				gameStarted = false;
 			}
 		}
 	}
 
-
 	// Changes ghosts from idle to scatter when Pacman starts moving
 	if (!gameStarted && pac->startedMoving)
 	{
 		gameStarted = true;
-		for (const std::unique_ptr<Ghost>& g : ghosts)
+		for (Ghost* g : ghosts)
 		{
 			if (g->GetState() == GhostState::Idle)
 			{
@@ -248,20 +437,13 @@ void Game::Draw() const
 	DrawMaze();
 	pac->Draw();
 
-	for (const std::unique_ptr<Ghost>& g : ghosts)
+	for (Ghost* g : ghosts)
 	{
 		g->Draw();
 	}
 
 	// Win text
-	bool pelletsLeft = false;
-	for (int y = 0; y < Cfg::GRID_HEIGHT && !pelletsLeft; ++y)
-	{
-		for (int x = 0; x < Cfg::GRID_WIDTH; ++x)
-		{
-			if (maze[y][x] == TileType::PELLET) pelletsLeft = true;
-		}
-	}
+	const bool pelletsLeft = pelletsRemaining > 0;
 
 	if (!gameStarted)
 	{
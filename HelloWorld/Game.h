@@ -1,9 +1,14 @@
 #pragma once
 
 // Includes
-#include <memory>
+#include <array>
+#include <cstddef>
+#include <random>
 
 #include "Utils.h"
+#include "Arena.h"
+#include "AudioMixer.h"
+#include "Maze.h"
 #include "Pacman.h"
 #include "Ghost.h"
 #include "IGameBoard.h"
@@ -14,7 +19,7 @@ enum class GhostType;
 
 // Game.h
 // The central coordinator of the Pac-Man game.
-// - Owns maze, Pac-Man, and ghosts
+// - Owns maze, Pac-Man, and ghosts; the actors and ghost FSMs live in one per-game arena
 // - Implements IGameBoard for ghost AI queries
 // - Manages global mode switching (Scatter/Chase), power-ups, and collisions
 class Game : public IGameBoard
@@ -22,21 +27,41 @@ class Game : public IGameBoard
 public:
 	// Functions
 	Game();
+	~Game();
 
-	static bool InBounds(int x, int y);
+	bool InBounds(int x, int y) const;
 	bool IsWall(int x, int y) const override;
+	bool GetNeighbour(int x, int y, const Play::Point2f& dir, int& nx, int& ny) const override;
+	float GetGhostSpeedMult(int x, int y) const override;
+	Play::Point2f WrapPosition(const Play::Point2f& pos) const override;
 
 	Play::Point2f GetScatterTarget(GhostType type) const override;
 	Play::Point2f GetPacDirection() const override;
 	Play::Point2f GetGhostGrid(GhostType type) const override;
 	Play::Point2f GetPacPosition() const override;
 	GlobalMode GetGlobalMode() const override { return globalMode; }
+	std::mt19937& GetRng() override { return rng; }
 
 	void BuildArena();
 	void SpawnPowerUp();
 	void ActivatePowerUp();
 
 	void Init();
+	// Start on a prebuilt layout (e.g. from GenerateMaze) instead of the default arena
+	void Init(const Maze& layout);
+	// Places the actors and resets the round (timers, mode, lives lost) on the current board
+	void InitActors();
+	// Tile writes go through SetTile so render caches can patch only what changed
+	void SetTile(int x, int y, TileType type);
+	const std::vector<int>& GetDirtyTiles() const { return dirtyTiles; }
+	void ResetTileTracking();
+
+	// Renders walls and pellets once into layers; FlushDirtyTiles then redraws only the pellet
+	// tiles changed since the last flush, and DrawMaze blits the layers
+	void BuildMazeLayers();
+	void FlushDirtyTiles();
+	void DrawWalls() const;
+	void DrawPellet(int x, int y) const;
 	void DrawMaze() const;
 
 	void Update(float dt);
@@ -50,13 +75,28 @@ public:
 		return (dx*dx + dy*dy) <= (radius*radius);
 	}
 
+	// Enough for Pac-Man, four ghosts and their FSMs; Game() asserts nothing spilled to the heap
+	static constexpr size_t ARENA_BYTES = 2048;
+
 	// Variables
-	TileType maze[Cfg::GRID_HEIGHT][Cfg::GRID_WIDTH]{};
-	std::unique_ptr<Pacman> pac;
-	std::vector<std::unique_ptr<Ghost>> ghosts;
+	// Declared first so it outlives everything that might point into it
+	alignas(std::max_align_t) std::byte arenaStorage[ARENA_BYTES];
+	Arena arena{ arenaStorage, sizeof(arenaStorage) };
+	Maze maze;
+	int pelletsRemaining = 0;
+	Play::Layer wallLayer;
+	Play::Layer pelletLayer;
+	// Tile indices changed since the last FlushDirtyTiles, deduplicated by dirtyMask
+	std::vector<int> dirtyTiles;
+	std::vector<uint8_t> dirtyMask;
+	Pacman* pac = nullptr;
+	std::array<Ghost*, 4> ghosts{};
 	float powerUpTimer = 0.0f;
 	bool powerUpPresent = false;
 	GlobalMode globalMode = GlobalMode::Scatter;
 	float modeTimer = Cfg::SCATTER_DURATION; // initial scatter time
 	bool gameStarted = false;
+	int livesLost = 0; // ghost catches since the round started
+	SoundId collectSound = INVALID_SOUND; // resolved by Init; stays invalid without a running mixer
+	std::mt19937 rng{ std::random_device{}() }; // per game, so instances on different threads never share it
 };
\ No newline at end of file
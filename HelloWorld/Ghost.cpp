@@ -2,6 +2,10 @@
 #include "IGameBoard.h"
 #include "FSM/GhostStates.h"
 #include "Modes.h"
+#include "Profiler.h"
+#include "AllocTracker.h"
+#include "Arena.h"
+#include <cassert>
 
 #pragma region Helpers
 
@@ -31,18 +35,21 @@ void Ghost::Init(GhostType t, int startGX, int startGY, Play::Colour col)
     baseSpeed = Cfg::BASE_GHOST_SPEED;
     speed = baseSpeed;
 
-    InitStateMachine();
+    assert(m_fsm && "Ghost::Init: InitStateMachine must run first");
+    m_fsm->Reset();
 }
 
-void Ghost::InitStateMachine()
+void Ghost::InitStateMachine(Arena& arena)
 {
-    m_fsm = std::make_unique<GhostStateMachine>(this);
+    ALLOC_SCOPE(AllocPhase::FsmSetup);
+    assert(!m_fsm && "InitStateMachine: already built");
+    m_fsm = arena.Create<GhostStateMachine>(this);
 
-    m_fsm->AddState(GhostState::Idle, MakeIdleState(this));
-    m_fsm->AddState(GhostState::Scatter, MakeScatterState(this));
-    m_fsm->AddState(GhostState::Chase, MakeChaseState(this));
-    m_fsm->AddState(GhostState::Frightened, MakeFrightenedState(this));
-    m_fsm->AddState(GhostState::Eaten, MakeEatenState(this));
+    m_fsm->AddState(GhostState::Idle, MakeIdleState(arena, this));
+    m_fsm->AddState(GhostState::Scatter, MakeScatterState(arena, this));
+    m_fsm->AddState(GhostState::Chase, MakeChaseState(arena, this));
+    m_fsm->AddState(GhostState::Frightened, MakeFrightenedState(arena, this));
+    m_fsm->AddState(GhostState::Eaten, MakeEatenState(arena, this));
 
     // Set initial state
     m_fsm->SetState(GhostState::Idle, nullptr);
@@ -96,34 +103,51 @@ void Ghost::ResetToSpawn()
 
 bool Ghost::Update(IGameBoard* board, int pacGX, int pacGY, float dt)
 {
-    // Update FSM
-    if (m_fsm) m_fsm->Update(board, pacGX, pacGY, dt);
-
-    // Movement code
+    // Sync grid coords on arrival so the FSM plans from the tile it is actually on.
+    // A step through a tunnel portal ends just off the board, so wrap back first.
     if (AtCenter(pos, target))
     {
+        if (board) pos = target = board->WrapPosition(pos);
         gx = int(pos.x) / Cfg::TILE_SIZE;
         gy = int(pos.y) / Cfg::TILE_SIZE;
-
-        int tx = gx + int(dir.x), ty = gy + int(dir.y);
-        if (board && board->IsWall(tx, ty)) dir = {0,0};
-        target = (board && !board->IsWall(tx, ty)) ? CenterOf(tx, ty) : CenterOf(gx, gy);
     }
 
-    Play::Point2f d{ target.x - pos.x, target.y - pos.y };
-    float dist = Distance(pos, target);
-    float step = speed * dt;
+    // Update FSM
+    {
+        PROFILE_GHOST_SCOPE(ProfPhase::GhostFsm, static_cast<int>(type));
+        if (m_fsm) m_fsm->Update(board, pacGX, pacGY, dt);
+    }
 
-    if (dist < Cfg::EPS || step >= dist) pos = target;
-    else
+    // Movement code
     {
-        pos.x += (d.x / dist) * step;
-        pos.y += (d.y / dist) * step;
+        PROFILE_GHOST_SCOPE(ProfPhase::GhostMove, static_cast<int>(type));
+        if (AtCenter(pos, target))
+        {
+            int nx, ny;
+            const bool open = board && board->GetNeighbour(gx, gy, dir, nx, ny);
+            if (board && !open) dir = {0,0};
+            target = open ? CenterOf(gx + int(dir.x), gy + int(dir.y)) : CenterOf(gx, gy);
+        }
+
+        Play::Point2f d{ target.x - pos.x, target.y - pos.y };
+        float dist = Distance(pos, target);
+        float step = speed * dt;
+
+        // Tunnel slow-down zones (eyes returning home are exempt, as in the arcade)
+        if (board && GetState() != GhostState::Eaten) step *= board->GetGhostSpeedMult(gx, gy);
+
+        if (dist < Cfg::EPS || step >= dist) pos = target;
+        else
+        {
+            pos.x += (d.x / dist) * step;
+            pos.y += (d.y / dist) * step;
+        }
     }
 
     // Check collision with Pac-Man - only if not in Eaten state
     if (GetState() != GhostState::Eaten && board)
     {
+        PROFILE_GHOST_SCOPE(ProfPhase::Collision, static_cast<int>(type));
         const Play::Point2f pacPos = board->GetPacPosition();
         const float ghostR = ActorRadius();
         const float pacR = ActorRadius();
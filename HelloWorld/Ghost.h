@@ -1,11 +1,11 @@
 #pragma once
 
-#include <memory>
 #include "Utils.h"
 #include "IGameBoard.h"
 #include "FSM/GhostStateMachine.h"
 
 enum class GlobalMode;
+class Arena;
 
 // Enumerations
 enum class GhostType
@@ -39,9 +39,9 @@ public:
 
 	// FSM API
 
-	// Build the FSM states and set the initial state.
-	// OnEnter may receive nullptr during initialization; states must handle that.
-	void InitStateMachine();
+	// Build the FSM and its states in `arena` (once per game) and set the initial state.
+	// Init restarts the same FSM in Idle. OnEnter may receive nullptr then; states must handle that.
+	void InitStateMachine(Arena& arena);
 	void SetState(GhostState newState, IGameBoard* board = nullptr);
 	GhostState GetState() const;
 
@@ -64,5 +64,5 @@ public:
 	Play::Colour baseColour{ Play::cRed };
 
 private:
-	std::unique_ptr<GhostStateMachine> m_fsm;
+	GhostStateMachine* m_fsm = nullptr; // owned by the game's arena
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <random>
+
 #include "Utils.h"
 #include "Modes.h"
 
@@ -14,6 +16,12 @@ public:
 
     // World queries
     virtual bool IsWall(int x, int y) const = 0;
+    // Neighbour of in-bounds tile (x, y) one step along dir, with tunnel wrap-around resolved.
+    // Returns false if that neighbour is a wall.
+    virtual bool GetNeighbour(int x, int y, const Play::Point2f& dir, int& nx, int& ny) const = 0;
+    virtual float GetGhostSpeedMult(int x, int y) const = 0; // < 1 in tunnel slow-down zones
+    // Brings a position that walked off the board through a tunnel portal back onto it
+    virtual Play::Point2f WrapPosition(const Play::Point2f& pos) const = 0;
 
     // Targets and positions used by ghost AI
     virtual Play::Point2f GetScatterTarget(GhostType type) const = 0;
@@ -23,4 +31,7 @@ public:
 
     // Global mode (Scatter/Chase)
     virtual GlobalMode GetGlobalMode() const = 0;
+
+    // The game's random number generator, so seeding it fixes the ghosts' random choices too
+    virtual std::mt19937& GetRng() = 0;
 };
@@ -0,0 +1,34 @@
+#pragma once
+
+// Includes
+#include <cstdio>
+
+// JsonString.h
+// Writes a string as a quoted JSON string, for the trace file and benchmark reports that are printed by hand.
+// Quotes, backslashes and control characters are escaped; every other byte (UTF-8 included) is copied as is.
+inline void WriteJsonString(FILE* file, const char* text)
+{
+	std::fputc('"', file);
+	for (const unsigned char* c = reinterpret_cast<const unsigned char*>(text); *c; ++c)
+	{
+		switch (*c)
+		{
+		case '"': std::fputs("\\\"", file); break;
+		case '\\': std::fputs("\\\\", file); break;
+		case '\n': std::fputs("\\n", file); break;
+		case '\r': std::fputs("\\r", file); break;
+		case '\t': std::fputs("\\t", file); break;
+		default:
+			if (*c < 0x20)
+			{
+				std::fprintf(file, "\\u%04x", *c);
+			}
+			else
+			{
+				std::fputc(*c, file);
+			}
+			break;
+		}
+	}
+	std::fputc('"', file);
+}
@@ -1,6 +1,10 @@
 // Includes
 #include "Utils.h"
 #include "Game.h"
+#include "AudioMixer.h"
+#include "FrameCapture.h"
+#include "Profiler.h"
+#include "Trace.h"
 
 // Our game instance
 static Game GameInstance;
@@ -8,23 +12,64 @@ static Game GameInstance;
 void MainGameEntry()
 {
 	Play::CreateManager(Cfg::DISPLAY_W, Cfg::DISPLAY_H, Cfg::DISPLAY_SCALE);
+	// Before Init, which looks up the sounds it plays; the game runs silently if there is no device
+	Mixer::Start();
 	GameInstance.Init();
+
+#ifdef PACMAN_ENABLE_TRACING
+	Tracing::Start("trace.json");
+#endif
 }
 
 bool MainGameUpdate(float elapsed)
 {
+	PROFILE_FRAME();
+	TRACE_BEGIN("frame", "Frame");
 	Play::ClearDrawingBuffer(Play::cBlack);
 
 	GameInstance.Update(elapsed);
-	GameInstance.Draw();
+	{
+		PROFILE_SCOPE(ProfPhase::Draw);
+		GameInstance.FlushDirtyTiles();
+		GameInstance.Draw();
+	}
+
+#ifdef PACMAN_ENABLE_PROFILER
+	// Last frame's breakdown; F10 writes the recent history to profile.csv
+	Profiler::DrawTimingBar({ 4, 4 }, { Cfg::DISPLAY_W / 2.0f, 6.0f });
+	if (Play::KeyPressed(Play::KEY_F10))
+	{
+		Profiler::DumpCsv("profile.csv");
+	}
+#endif
+
+	{
+		PROFILE_SCOPE(ProfPhase::Present);
+		Play::PresentDrawingBuffer();
+	}
 
-	Play::PresentDrawingBuffer();
+	// F9 toggles recording to ./capture
+	if (Play::KeyPressed(Play::KEY_F9))
+	{
+		if (IsFrameCaptureActive())
+		{
+			StopFrameCapture();
+		}
+		else
+		{
+			StartFrameCapture();
+		}
+	}
 
+	TRACE_END("frame", "Frame");
 	return Play::KeyDown(KEY_ESCAPE);
 }
 
 int MainGameExit()
 {
+	StopFrameCapture();
+	Mixer::Stop();
+	Tracing::Stop();
 	Play::DestroyManager();
 	return 0;
 }
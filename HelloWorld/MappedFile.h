@@ -0,0 +1,35 @@
+#pragma once
+
+// Includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// MappedFile.h
+// A whole file mapped read-only into memory (mmap, or a file mapping view on Windows).
+// - Pages are read in by the OS on first touch and can be dropped again under memory pressure,
+//   so large assets cost address space rather than resident memory
+// - Move-only; the mapping is released on Close or destruction
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Fails for missing or empty files
+	bool Open(const std::string& path);
+	void Close();
+
+	bool IsOpen() const { return m_data != nullptr; }
+	const uint8_t* Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+};
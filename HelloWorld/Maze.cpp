@@ -0,0 +1,34 @@
+// This file's header
+#include "Maze.h"
+
+// Other includes
+#include <cassert>
+
+void Maze::BuildLinks()
+{
+	assert(width < (1 << 15) && height < (1 << 15) && "Maze::BuildLinks: packed links hold 15-bit coordinates");
+
+	// Same order as DirIndex(): up, right, down, left, stay
+	static constexpr int DX[5] = { 0, 1, 0, -1, 0 };
+	static constexpr int DY[5] = { -1, 0, 1, 0, 0 };
+
+	links.resize(tiles.size());
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			TileLinks& tile = links[static_cast<size_t>(y) * width + x];
+			const bool open = (*this)[y][x] != TileType::WALL;
+
+			for (int d = 0; d < 5; ++d)
+			{
+				// Stepping off the board only happens from border tiles and lands on the opposite border
+				const int nx = (x + DX[d] + width) % width;
+				const int ny = (y + DY[d] + height) % height;
+				tile.next[d] = (open && (*this)[ny][nx] != TileType::WALL) ? (ny << 16 | nx) : NO_LINK;
+			}
+
+			tile.ghostSpeedMult = (*this)[y][x] == TileType::TUNNEL ? Cfg::TUNNEL_SPEED_MULT : 1.0f;
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <vector>
+
+#include "Utils.h"
+
+// Maze.h
+// Row-major tile grid filled by Game::BuildArena or the maze generator.
+// - maze[y][x] indexing, so callers read it like a fixed 2D array
+// - Sized at runtime, which lets benchmarks scale the board freely
+// - Carries the Pac-Man spawn tile; ghosts spawn around the grid centre
+// - Precomputed neighbour table so movement/AI never branch on board edges
+//
+// Tunnel portals live in the tile data: a non-wall tile on the border links to the tile on the
+// opposite border of the same row/column, provided that one is open too.
+struct Maze
+{
+	// Neighbour links of one tile. Indexed by DirIndex(): up, right, down, left, then "no move".
+	// Entries are packed (y << 16 | x) with tunnel wrap-around already applied, or NO_LINK for walls.
+	struct TileLinks
+	{
+		int32_t next[5];
+		float ghostSpeedMult;
+	};
+	static constexpr int32_t NO_LINK = -1;
+
+	// Functions
+	void Resize(int w, int h, TileType fill)
+	{
+		width = w;
+		height = h;
+		tiles.assign(static_cast<size_t>(w) * h, fill);
+		links.clear();
+	}
+
+	// Rebuild the neighbour table; call after changing walls or tunnels (pellets don't matter)
+	void BuildLinks();
+
+	bool InBounds(int x, int y) const
+	{
+		return x >= 0 && y >= 0 && x < width && y < height;
+	}
+
+	// Maps a unit grid step to its TileLinks slot; {0,0} maps to the tile itself
+	static int DirIndex(int dx, int dy)
+	{
+		return dx != 0 ? 2 - dx : (dy != 0 ? 1 + dy : 4);
+	}
+
+	const TileLinks& LinksAt(int x, int y) const { return links[static_cast<size_t>(y) * width + x]; }
+
+	TileType* operator[](int y) { return tiles.data() + static_cast<size_t>(y) * width; }
+	const TileType* operator[](int y) const { return tiles.data() + static_cast<size_t>(y) * width; }
+
+	// Variables
+	int width = 0, height = 0;
+	int pacSpawnX = 0, pacSpawnY = 0;
+	std::vector<TileType> tiles;
+	std::vector<TileLinks> links;
+};
@@ -0,0 +1,228 @@
+// This file's header
+#include "MazeGenerator.h"
+
+// Other includes
+#include <algorithm>
+#include <cassert>
+#include <random>
+
+// MazeGenerator.cpp
+// Cells sit on odd coordinates with wall tiles between them. Only the left half is generated;
+// every write goes through Carve(), which mirrors it, so the board stays symmetric by construction.
+
+#pragma region Helpers
+namespace {
+
+	// Cell steps (up, right, down, left)
+	const int DX[4] = { 0, 1, 0, -1 };
+	const int DY[4] = { -1, 0, 1, 0 };
+
+	// std::uniform_int_distribution is implementation defined, so reduce the (fully specified)
+	// mt19937 output by hand to get the same maze from every compiler
+	int RandRange(std::mt19937& rng, int n) { return static_cast<int>(rng() % static_cast<uint32_t>(n)); }
+	bool RandChance(std::mt19937& rng, float p) { return static_cast<float>(rng() >> 8) * (1.0f / 16777216.0f) < p; }
+
+	// Largest odd value <= v
+	int LastOdd(int v) { return (v % 2 != 0) ? v : v - 1; }
+
+	// Writes a tile and its mirror image across the vertical centre line
+	void Carve(Maze& maze, int x, int y, TileType tile)
+	{
+		maze[y][x] = tile;
+		maze[y][maze.width - 1 - x] = tile;
+	}
+
+}
+#pragma endregion
+
+void GenerateMaze(const MazeGenParams& params, Maze& out)
+{
+	assert(params.width >= 7 && params.height >= 7 && "GenerateMaze: board must be at least 7x7");
+	const int w = std::max(params.width, 7);
+	const int h = std::max(params.height, 7);
+	out.Resize(w, h, TileType::WALL);
+
+	std::mt19937 rng(params.seed);
+
+	// Cell grid of the left half (the centre column belongs to both halves)
+	const int halfW = (w + 1) / 2;
+	const int lastX = LastOdd(std::min(halfW - 1, w - 2));
+	const int lastY = LastOdd(h - 2);
+	const int cellsX = lastX / 2 + 1;
+	const int cellsY = lastY / 2 + 1;
+
+	// 1) Spanning maze over the cells (iterative recursive backtracker)
+	std::vector<uint8_t> visited(static_cast<size_t>(cellsX) * cellsY, 0);
+	std::vector<int> stack;
+	stack.reserve(visited.size());
+
+	const int start = RandRange(rng, cellsX * cellsY);
+	visited[start] = 1;
+	stack.push_back(start);
+	Carve(out, 1 + 2 * (start % cellsX), 1 + 2 * (start / cellsX), TileType::PELLET);
+
+	while (!stack.empty())
+	{
+		const int cx = stack.back() % cellsX;
+		const int cy = stack.back() / cellsX;
+
+		int options[4];
+		int count = 0;
+		for (int d = 0; d < 4; ++d)
+		{
+			const int nx = cx + DX[d], ny = cy + DY[d];
+			if (nx >= 0 && ny >= 0 && nx < cellsX && ny < cellsY && !visited[ny * cellsX + nx])
+			{
+				options[count++] = d;
+			}
+		}
+
+		if (count == 0)
+		{
+			stack.pop_back();
+			continue;
+		}
+
+		const int d = options[RandRange(rng, count)];
+		const int nx = cx + DX[d], ny = cy + DY[d];
+		visited[ny * cellsX + nx] = 1;
+		Carve(out, 1 + 2 * cx + DX[d], 1 + 2 * cy + DY[d], TileType::PELLET); // passage
+		Carve(out, 1 + 2 * nx, 1 + 2 * ny, TileType::PELLET);                 // cell
+		stack.push_back(ny * cellsX + nx);
+	}
+
+	// 2) Extra junctions: wall tiles between two cells have exactly one odd coordinate
+	for (int y = 1; y <= lastY; ++y)
+	{
+		for (int x = 1; x <= lastX; ++x)
+		{
+			if ((x % 2) != (y % 2) && out[y][x] == TileType::WALL && RandChance(rng, params.junctionDensity))
+			{
+				Carve(out, x, y, TileType::PELLET);
+			}
+		}
+	}
+
+	// 3) Join the halves where the mirrored cell columns do not already touch or coincide
+	const int mirrorX = w - 1 - lastX;
+	if (mirrorX - lastX > 1)
+	{
+		const int forcedY = 1 + 2 * RandRange(rng, cellsY);
+		for (int y = 1; y <= lastY; y += 2)
+		{
+			if (y == forcedY || RandChance(rng, params.junctionDensity))
+			{
+				Carve(out, lastX + 1, y, TileType::PELLET);
+			}
+		}
+	}
+
+	// 4) Dead ends: open one more side of every cell with a single exit
+	if (params.removeDeadEnds)
+	{
+		for (int cy = 0; cy < cellsY; ++cy)
+		{
+			for (int cx = 0; cx < cellsX; ++cx)
+			{
+				const int x = 1 + 2 * cx, y = 1 + 2 * cy;
+				int exits = 0;
+				int walled[4];
+				int count = 0;
+				for (int d = 0; d < 4; ++d)
+				{
+					if (out[y + DY[d]][x + DX[d]] != TileType::WALL)
+					{
+						++exits;
+					}
+					else
+					{
+						// Only knock through if there is board on the other side
+						const int bx = x + 2 * DX[d], by = y + 2 * DY[d];
+						if (bx >= 1 && by >= 1 && bx <= w - 2 && by <= h - 2)
+						{
+							walled[count++] = d;
+						}
+					}
+				}
+
+				if (exits == 1 && count > 0)
+				{
+					const int d = walled[RandRange(rng, count)];
+					Carve(out, x + DX[d], y + DY[d], TileType::PELLET);
+				}
+			}
+		}
+	}
+
+	// 5) Tunnels: a cell row always sits right inside the border, so each one joins a corridor
+	const int tunnelLength = std::clamp(params.tunnelLength, 1, lastX + 1);
+	for (int t = 0; t < params.tunnels; ++t)
+	{
+		const int y = 1 + 2 * RandRange(rng, cellsY);
+		for (int x = 0; x < tunnelLength; ++x)
+		{
+			Carve(out, x, y, TileType::TUNNEL);
+		}
+	}
+
+	// 6) Ghost house: open room around the centre, where Game::Init places the ghosts.
+	// It always overlaps the last cell column, so it is joined to the corridors.
+	const int houseX = w / 2, houseY = h / 2;
+	for (int y = houseY; y <= houseY + 2; ++y)
+	{
+		for (int x = houseX - 2; x <= houseX + 2; ++x)
+		{
+			Carve(out, x, y, TileType::EMPTY);
+		}
+	}
+
+	// 7) Pac-Man starts on the cell nearest the arcade spot: below the ghost house, left of centre
+	out.pacSpawnX = std::clamp(LastOdd(houseX - 4), 1, lastX);
+	out.pacSpawnY = std::clamp(LastOdd(h * 3 / 4), 1, lastY);
+
+	assert(IsMazeConnected(out) && "GenerateMaze: produced a disconnected maze");
+}
+
+bool IsMazeConnected(const Maze& maze)
+{
+	if (!maze.InBounds(maze.pacSpawnX, maze.pacSpawnY) || maze[maze.pacSpawnY][maze.pacSpawnX] == TileType::WALL)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> reached(maze.tiles.size(), 0);
+	std::vector<int> open;
+	open.reserve(maze.tiles.size());
+
+	const int start = maze.pacSpawnY * maze.width + maze.pacSpawnX;
+	reached[start] = 1;
+	open.push_back(start);
+	size_t reachedCount = 1;
+
+	while (!open.empty())
+	{
+		const int x = open.back() % maze.width;
+		const int y = open.back() / maze.width;
+		open.pop_back();
+
+		for (int d = 0; d < 4; ++d)
+		{
+			const int nx = x + DX[d], ny = y + DY[d];
+			if (!maze.InBounds(nx, ny) || maze[ny][nx] == TileType::WALL)
+			{
+				continue;
+			}
+
+			const int idx = ny * maze.width + nx;
+			if (!reached[idx])
+			{
+				reached[idx] = 1;
+				++reachedCount;
+				open.push_back(idx);
+			}
+		}
+	}
+
+	const size_t openCount = maze.tiles.size() - std::count(maze.tiles.begin(), maze.tiles.end(), TileType::WALL);
+	return reachedCount == openCount;
+}
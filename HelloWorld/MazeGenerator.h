@@ -0,0 +1,37 @@
+#pragma once
+
+// Includes
+#include <cstdint>
+
+#include "Maze.h"
+
+// MazeGenerator.h
+// Seeded generator for classic-style mazes of any size (28x31 up to 1024x1024 and beyond).
+// - Left/right mirror symmetric, like the arcade board
+// - Every open tile is reachable from every other open tile
+// - The same params produce the same maze on every platform and standard library
+struct MazeGenParams
+{
+	int width = Cfg::GRID_WIDTH;   // minimum 7
+	int height = Cfg::GRID_HEIGHT; // minimum 7
+	uint32_t seed = 1;
+
+	// Chance of knocking out each remaining wall between two corridors once the spanning maze is carved.
+	// 0 keeps a single route between any two tiles, 1 opens the board into a lattice.
+	float junctionDensity = 0.15f;
+
+	// Classic boards have no dead ends; each one is joined to a neighbouring corridor
+	bool removeDeadEnds = true;
+
+	// Side tunnels: rows opened through both borders (a portal pair), with the outermost
+	// tunnelLength tiles on each side marked as ghost slow-down zone
+	int tunnels = 1;
+	int tunnelLength = 3;
+};
+
+// Fills `out` with a new maze, reusing its storage. Corridors hold pellets, the ghost house is empty.
+// Call Maze::BuildLinks (Game::Init does) before moving actors on it.
+void GenerateMaze(const MazeGenParams& params, Maze& out);
+
+// True if every non-wall tile is reachable from the Pac-Man spawn
+bool IsMazeConnected(const Maze& maze);
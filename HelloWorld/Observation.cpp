@@ -0,0 +1,72 @@
+// This file's header
+#include "Observation.h"
+
+// Other includes
+#include <cassert>
+#include <cstring>
+
+#include "Game.h"
+
+// State planes are indexed by GhostState
+static_assert(OBS_STATE_EATEN - OBS_STATE_IDLE == static_cast<int>(GhostState::Eaten), "GhostState order changed");
+
+ObservationLayout GetObservationLayout(const Game& game)
+{
+	return { game.maze.width, game.maze.height };
+}
+
+void WriteObservation(const Game& game, float* out)
+{
+	const ObservationLayout layout = GetObservationLayout(game);
+	const size_t plane = layout.PlaneSize();
+
+	// Tile planes in one pass over the maze
+	float* walls = out + OBS_WALL * plane;
+	float* pellets = out + OBS_PELLET * plane;
+	float* powerUps = out + OBS_POWERUP * plane;
+	const TileType* tiles = game.maze.tiles.data();
+	for (size_t i = 0; i < plane; ++i)
+	{
+		walls[i] = tiles[i] == TileType::WALL ? 1.0f : 0.0f;
+		pellets[i] = tiles[i] == TileType::PELLET ? 1.0f : 0.0f;
+		powerUps[i] = tiles[i] == TileType::POWERUP ? 1.0f : 0.0f;
+	}
+
+	// Actor planes are sparse: clear them, then mark the occupied tiles
+	float* actors = out + OBS_PACMAN * plane;
+	std::memset(actors, 0, (OBS_CHANNEL_COUNT - OBS_PACMAN) * plane * sizeof(float));
+
+	const auto cell = [&](int channel, int x, int y) -> float& {
+		return out[channel * plane + static_cast<size_t>(y) * layout.width + x];
+	};
+
+	cell(OBS_PACMAN, game.pac->gx, game.pac->gy) = 1.0f;
+
+	assert(game.ghosts.size() <= OBS_STATE_IDLE - OBS_GHOST_0 && "WriteObservation: more ghosts than ghost planes");
+	for (size_t i = 0; i < game.ghosts.size(); ++i)
+	{
+		const Ghost& g = *game.ghosts[i];
+		cell(OBS_GHOST_0 + static_cast<int>(i), g.gx, g.gy) = 1.0f;
+		cell(OBS_STATE_IDLE + static_cast<int>(g.GetState()), g.gx, g.gy) = 1.0f;
+	}
+
+	float* scalars = out + layout.ScalarOffset();
+	scalars[OBS_POWERUP_TIMER] = game.powerUpTimer;
+	scalars[OBS_MODE_TIMER] = game.modeTimer;
+	scalars[OBS_GLOBAL_MODE] = game.globalMode == GlobalMode::Chase ? 1.0f : 0.0f;
+}
+
+void WriteObservationBatch(const Game* const* games, int count, float* out)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	const size_t stride = GetObservationLayout(*games[0]).Size();
+	for (int i = 0; i < count; ++i)
+	{
+		assert(GetObservationLayout(*games[i]).Size() == stride && "WriteObservationBatch: games differ in maze size");
+		WriteObservation(*games[i], out + i * stride);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// Includes
+#include <cstddef>
+
+// Forward Declarations
+class Game;
+
+// Observation.h
+// Compact symbolic observation of a Game tick for RL training and inference.
+// - One float32 grid cell per maze tile instead of rendered pixels
+// - Written into caller-owned memory without allocating
+// - Batches are laid out back to back, so a [N][Size] buffer can be handed to inference as-is
+//
+// Per game: OBS_CHANNEL_COUNT planes of height x width (row-major), then OBS_SCALAR_COUNT scalars.
+
+// Planes (1.0 where the condition holds, else 0.0)
+enum ObsChannel : int
+{
+	OBS_WALL,
+	OBS_PELLET,
+	OBS_POWERUP,
+	OBS_PACMAN,
+	OBS_GHOST_0,       // one plane per ghost, in Game::ghosts order
+	OBS_GHOST_1,
+	OBS_GHOST_2,
+	OBS_GHOST_3,
+	OBS_STATE_IDLE,    // one plane per GhostState, marking the ghosts currently in it
+	OBS_STATE_SCATTER,
+	OBS_STATE_CHASE,
+	OBS_STATE_FRIGHTENED,
+	OBS_STATE_EATEN,
+	OBS_CHANNEL_COUNT
+};
+
+// Scalars after the planes
+enum ObsScalar : int
+{
+	OBS_POWERUP_TIMER, // seconds of power-up left, 0 when none is active
+	OBS_MODE_TIMER,    // seconds until the next scatter/chase switch
+	OBS_GLOBAL_MODE,   // 0 scatter, 1 chase
+	OBS_SCALAR_COUNT
+};
+
+struct ObservationLayout
+{
+	int width = 0, height = 0;
+
+	size_t PlaneSize() const { return static_cast<size_t>(width) * height; }
+	size_t ScalarOffset() const { return OBS_CHANNEL_COUNT * PlaneSize(); }
+	size_t Size() const { return ScalarOffset() + OBS_SCALAR_COUNT; } // floats per game
+};
+
+ObservationLayout GetObservationLayout(const Game& game);
+
+// Writes one observation; `out` must hold GetObservationLayout(game).Size() floats
+void WriteObservation(const Game& game, float* out);
+
+// Writes `count` observations contiguously; all games must share the same maze size
+void WriteObservationBatch(const Game* const* games, int count, float* out);
@@ -48,6 +48,8 @@ void Pacman::Update(Game* game, float dt)
 {
 	if (AtCenter(pos, target))
 	{
+		// A step through a tunnel portal ends just off the board
+		pos = target = game->WrapPosition(pos);
 		gx = int(pos.x) / Cfg::TILE_SIZE;
 		gy = int(pos.y) / Cfg::TILE_SIZE;
 
@@ -56,33 +58,30 @@ void Pacman::Update(Game* game, float dt)
 		{
 			if (game->maze[gy][gx] == TileType::PELLET)
 			{
-				game->maze[gy][gx] = TileType::EMPTY;
+				game->SetTile(gx, gy, TileType::EMPTY);
+				Mixer::PlaySound(game->collectSound);
 			}
 			else if (game->maze[gy][gx] == TileType::POWERUP)
 			{
-				game->maze[gy][gx] = TileType::EMPTY;
+				game->SetTile(gx, gy, TileType::EMPTY);
 				game->ActivatePowerUp();
 			}
 		}
 
 		// Try queued first
-		int qx = gx + int(queued.x), qy = gy + int(queued.y);
-		if ((queued.x || queued.y) && !game->IsWall(qx, qy))
+		int nx, ny;
+		if ((queued.x || queued.y) && game->GetNeighbour(gx, gy, queued, nx, ny))
 		{
 			dir = queued;
 		}
-		else
+		else if (!game->GetNeighbour(gx, gy, dir, nx, ny))
 		{
-			int cx = gx + int(dir.x), cy = gy + int(dir.y);
-			if (game->IsWall(cx, cy))
-			{
-				dir = { 0,0 };
-			}
+			dir = { 0,0 };
 		}
 
-		// Next target
-		int tx = gx + int(dir.x), ty = gy + int(dir.y);
-		target = !game->IsWall(tx, ty) ? CenterOf(tx, ty) : CenterOf(gx, gy);
+		// Next target. Through a portal this is the unwrapped centre just off the board,
+		// so Pac-Man visibly walks out before reappearing on the far side.
+		target = CenterOf(gx + int(dir.x), gy + int(dir.y));
 	}
 
 	StepTowards(target, dt);
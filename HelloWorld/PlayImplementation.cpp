@@ -0,0 +1,6 @@
+// PlayImplementation.cpp
+// The one translation unit which compiles the PlayBuffer library's implementation, for the Play target.
+// PLAY_USING_GAMEOBJECT_MANAGER is defined by the target so every user of Play.h sees the same declarations.
+// The game itself draws through RaylibPlayCompat.h and doesn't link this.
+#define PLAY_IMPLEMENTATION
+#include "Play.h"
@@ -0,0 +1,153 @@
+// This file's header
+#include "Profiler.h"
+
+// Other includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#pragma region Helpers
+namespace {
+
+	struct ProfilerState
+	{
+		FrameProfile current;
+		uint64_t frameStart = 0;
+		FrameProfile history[PROFILE_HISTORY];
+		uint64_t recorded = 0; // frames written to history
+	};
+
+	thread_local ProfilerState t_state;
+
+	const char* const PHASE_NAMES[PROF_PHASE_COUNT] = {
+		"mode_timer", "pacman", "power_up", "ghost_fsm", "ghost_move", "collision", "draw", "present"
+	};
+
+	const Play::Colour PHASE_COLOURS[PROF_PHASE_COUNT] = {
+		Play::cWhite, Play::cYellow, Play::cMagenta, Play::cRed, Play::cOrange, Play::cCyan, Play::cGreen, Play::cBlue
+	};
+
+	// GhostType order
+	const char* const GHOST_NAMES[PROF_GHOST_COUNT] = { "blinky", "inky", "pinky", "clyde" };
+
+	constexpr float FRAME_BUDGET_NS = 1e9f / 60.0f;
+
+}
+#pragma endregion
+
+namespace Profiler
+{
+	uint64_t NowNs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	void AddSample(ProfPhase phase, uint64_t ns, int ghost)
+	{
+		t_state.current.phaseNs[static_cast<int>(phase)] += ns;
+		if (ghost >= 0 && ghost < PROF_GHOST_COUNT)
+		{
+			t_state.current.ghostNs[ghost] += ns;
+		}
+	}
+
+	void BeginFrame()
+	{
+		ProfilerState& s = t_state;
+		const uint64_t now = NowNs();
+		if (s.frameStart != 0)
+		{
+			s.current.totalNs = now - s.frameStart;
+			s.history[s.recorded % PROFILE_HISTORY] = s.current;
+			++s.recorded;
+		}
+
+		s.current = {};
+		s.current.frame = s.recorded;
+		s.frameStart = now;
+	}
+
+	const FrameProfile* GetFrame(int age)
+	{
+		const ProfilerState& s = t_state;
+		if (age < 0 || age >= PROFILE_HISTORY || static_cast<uint64_t>(age) >= s.recorded)
+		{
+			return nullptr;
+		}
+		return &s.history[(s.recorded - 1 - age) % PROFILE_HISTORY];
+	}
+
+	const char* PhaseName(ProfPhase phase)
+	{
+		return PHASE_NAMES[static_cast<int>(phase)];
+	}
+
+	void DrawTimingBar(const Play::Point2f& topLeft, const Play::Point2f& size)
+	{
+		const FrameProfile* frame = GetFrame(0);
+		if (!frame)
+		{
+			return;
+		}
+
+		// Dark backing for the remainder (work outside any scope), then one segment per phase
+		const float scale = size.x / FRAME_BUDGET_NS;
+		const float totalW = std::min(frame->totalNs * scale, size.x);
+		Play::DrawRect(topLeft, { topLeft.x + totalW, topLeft.y + size.y }, { 64, 64, 64, 255 });
+
+		float x = topLeft.x;
+		for (int i = 0; i < PROF_PHASE_COUNT; ++i)
+		{
+			const float w = frame->phaseNs[i] * scale;
+			if (w <= 0.0f)
+			{
+				continue;
+			}
+			const float right = std::min(x + w, topLeft.x + size.x);
+			Play::DrawRect({ x, topLeft.y }, { right, topLeft.y + size.y }, PHASE_COLOURS[i]);
+			x = right;
+		}
+
+		// Budget outline
+		Play::DrawRect(topLeft, { topLeft.x + size.x, topLeft.y + size.y }, Play::cWhite, false);
+	}
+
+	bool DumpCsv(const char* path)
+	{
+		FILE* file = std::fopen(path, "w");
+		if (!file)
+		{
+			return false;
+		}
+
+		std::fprintf(file, "frame,total_us");
+		for (int i = 0; i < PROF_PHASE_COUNT; ++i)
+		{
+			std::fprintf(file, ",%s_us", PHASE_NAMES[i]);
+		}
+		for (int g = 0; g < PROF_GHOST_COUNT; ++g)
+		{
+			std::fprintf(file, ",%s_us", GHOST_NAMES[g]);
+		}
+		std::fprintf(file, "\n");
+
+		const uint64_t count = std::min<uint64_t>(t_state.recorded, PROFILE_HISTORY);
+		for (int age = static_cast<int>(count) - 1; age >= 0; --age)
+		{
+			const FrameProfile& frame = *GetFrame(age);
+			std::fprintf(file, "%llu,%.2f", static_cast<unsigned long long>(frame.frame), frame.totalNs / 1000.0);
+			for (int i = 0; i < PROF_PHASE_COUNT; ++i)
+			{
+				std::fprintf(file, ",%.2f", frame.phaseNs[i] / 1000.0);
+			}
+			for (int g = 0; g < PROF_GHOST_COUNT; ++g)
+			{
+				std::fprintf(file, ",%.2f", frame.ghostNs[g] / 1000.0);
+			}
+			std::fprintf(file, "\n");
+		}
+
+		return std::fclose(file) == 0;
+	}
+}
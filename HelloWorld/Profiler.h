@@ -0,0 +1,84 @@
+#pragma once
+
+// Includes
+#include <cstdint>
+
+#include "Utils.h"
+
+// Profiler.h
+// Scoped frame-phase timers for the raylib build (Play.h's TimingBar equivalent).
+// - PROFILE_SCOPE(phase) times the rest of the enclosing block and adds it to the phase's total for the frame
+// - PROFILE_GHOST_SCOPE(phase, ghost) does the same and also adds it to that ghost's own total, so one slow ghost
+//   isn't hidden in the sum over all four
+// - PROFILE_FRAME() closes the current frame into a ring of the last PROFILE_HISTORY frames
+// - Results can be drawn as a stacked timing bar or dumped as CSV
+// Scopes compile to nothing unless PACMAN_ENABLE_PROFILER is defined (CMake option of the same name).
+// State is per thread, so headless games running in parallel each profile themselves.
+
+enum class ProfPhase : uint8_t
+{
+	ModeTimer,
+	Pacman,
+	PowerUp,
+	GhostFsm,  // all ghosts' state machines (each ghost's share is in FrameProfile::ghostNs)
+	GhostMove, // all ghosts' movement
+	Collision, // ghost overlap tests and their resolution
+	Draw,
+	Present,   // includes waiting for the frame limiter
+	Count
+};
+
+constexpr int PROF_PHASE_COUNT = static_cast<int>(ProfPhase::Count);
+constexpr int PROF_GHOST_COUNT = 4; // indexed by GhostType
+constexpr int PROFILE_HISTORY = 256;
+
+struct FrameProfile
+{
+	uint64_t frame = 0;
+	uint64_t totalNs = 0; // PROFILE_FRAME to PROFILE_FRAME, so untimed work shows up as the remainder
+	uint64_t phaseNs[PROF_PHASE_COUNT] = {};
+	uint64_t ghostNs[PROF_GHOST_COUNT] = {}; // each ghost's PROFILE_GHOST_SCOPE time, all phases together
+};
+
+namespace Profiler
+{
+	uint64_t NowNs();
+
+	// ghost is a GhostType index, or -1 for samples that belong to no ghost
+	void AddSample(ProfPhase phase, uint64_t ns, int ghost = -1);
+	void BeginFrame();
+
+	// age 0 is the last completed frame; nullptr if fewer than age + 1 frames were recorded
+	const FrameProfile* GetFrame(int age);
+	const char* PhaseName(ProfPhase phase);
+
+	// One stacked bar for the last completed frame; the full width is one 60 Hz frame
+	void DrawTimingBar(const Play::Point2f& topLeft, const Play::Point2f& size);
+
+	// Writes the recorded history, oldest first, one row per frame with times in microseconds
+	bool DumpCsv(const char* path);
+
+	struct Scope
+	{
+		explicit Scope(ProfPhase phase, int ghost = -1) : phase(phase), ghost(ghost), start(NowNs()) {}
+		~Scope() { AddSample(phase, NowNs() - start, ghost); }
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		ProfPhase phase;
+		int ghost;
+		uint64_t start;
+	};
+}
+
+#ifdef PACMAN_ENABLE_PROFILER
+	#define PROFILE_CONCAT_INNER(a, b) a##b
+	#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+	#define PROFILE_SCOPE(phase) const Profiler::Scope PROFILE_CONCAT(profileScope_, __LINE__)(phase)
+	#define PROFILE_GHOST_SCOPE(phase, ghost) const Profiler::Scope PROFILE_CONCAT(profileScope_, __LINE__)(phase, ghost)
+	#define PROFILE_FRAME() Profiler::BeginFrame()
+#else
+	#define PROFILE_SCOPE(phase) ((void)0)
+	#define PROFILE_GHOST_SCOPE(phase, ghost) ((void)0)
+	#define PROFILE_FRAME() ((void)0)
+#endif
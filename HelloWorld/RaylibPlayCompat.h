@@ -1,9 +1,15 @@
 #pragma once
 
 #include "raylib.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 #include <cstdlib>
+#include <cstring>
+#include <string>
 
 // =========================
 // Play Namespace
@@ -34,6 +40,7 @@ constexpr auto cYellow = YELLOW;
 constexpr auto cMagenta = MAGENTA;
 constexpr auto cOrange = ORANGE;
 constexpr Colour cCyan = { 0, 255, 255, 255 };
+constexpr auto cTransparent = BLANK;
 
 // -------------------------
 // Key Constants
@@ -43,6 +50,8 @@ constexpr int KEY_DOWN = ::KEY_DOWN;
 constexpr int KEY_LEFT = ::KEY_LEFT;
 constexpr int KEY_RIGHT = ::KEY_RIGHT;
 constexpr int KEY_ESCAPE = ::KEY_ESCAPE;
+constexpr int KEY_F9 = ::KEY_F9;
+constexpr int KEY_F10 = ::KEY_F10;
 
 // -------------------------
 // Public API
@@ -50,21 +59,153 @@ constexpr int KEY_ESCAPE = ::KEY_ESCAPE;
 inline void CreateManager(const int displayWidth, const int displayHeight, const int displayScale);
 inline void DestroyManager();
 inline bool KeyDown(const int key);
+inline bool KeyPressed(const int key); // true only on the frame the key goes down
 inline void ClearDrawingBuffer(const Colour& colour);
 inline void PresentDrawingBuffer();
 inline void DrawRect(const Point2f& topLeft, const Point2f& bottomRight, const Colour& colour, bool filled = true);
 inline void DrawCircle(const Point2f& center, int radius, const Colour& colour);
-inline void DrawDebugText(const Point2f& pos, const char* text);
+inline void DrawDebugText(const Point2f& pos, const char* text, int fontSize = 20, Colour col = cWhite);
+
+// Offscreen layers: render textures drawn into once (or rarely) and blitted every frame.
+// Creation fails without a window, so headless callers fall back to immediate drawing.
+struct Layer {
+    RenderTexture2D target{};
+    int generation = 0; // manager instance that created it, 0 = never created
+};
+inline bool CreateLayer(Layer& layer, int width, int height);
+inline void DestroyLayer(Layer& layer);
+inline bool IsLayerValid(const Layer& layer);
+inline void BeginLayer(const Layer& layer);
+inline void EndLayer();
+inline void ClearRect(const Point2f& topLeft, const Point2f& bottomRight, const Colour& colour);
+inline void DrawLayer(const Layer& layer, const Point2f& topLeft);
+
+// Software render target: while one is bound on a thread, ClearDrawingBuffer, DrawRect, DrawCircle
+// and ClearRect rasterize on the CPU into the caller's buffer instead of going through raylib.
+// No window or GL context is needed and each thread binds its own target, so many game instances
+// can render in parallel. Layers report invalid while bound (callers draw immediately instead)
+// and DrawDebugText is skipped, as there is no CPU glyph rasterizer.
+enum class PixelFormat {
+    RGBA8,   // 4 bytes per pixel, R G B A in memory order
+    Indexed8 // 1 byte per pixel, index of the nearest palette colour
+};
+struct SoftwareTarget {
+    uint8_t* pixels = nullptr; // RGBA8 rows must be 4-byte aligned
+    int width = 0, height = 0;
+    int pitch = 0;             // bytes per row
+    PixelFormat format = PixelFormat::RGBA8;
+    const Colour* palette = nullptr;
+    int paletteSize = 0;
+};
+inline void SetSoftwareTarget(SoftwareTarget* target); // nullptr goes back to raylib
+inline SoftwareTarget* GetSoftwareTarget();
+
+// Sprite atlas: every png in a directory is cut into frames and packed into one or a few texture
+// pages at load. Frame counts come from the file name the way PlayBuffer reads them: name_4 is 4
+// frames across, name_10x10 is 10 across by 10 down. DrawSprite only records; consecutive sprites
+// are submitted together as one textured quad batch per page, flushed before any other draw call
+// (as circles are), so many sprites cost one texture bind. Pages are also kept on the CPU so
+// software targets can draw sprites; without a window only that path is available.
+struct AtlasFrame {
+    int page = 0;
+    Rectangle source{}; // pixels within the page
+};
+struct AtlasSprite {
+    std::string name;          // file name without extension, uppercase
+    int width = 0, height = 0; // of one frame
+    int firstFrame = 0, frameCount = 0;
+};
+struct SpriteAtlas {
+    std::vector<Image> pages;        // RGBA8
+    std::vector<Texture2D> textures; // one per page, empty if loaded without a window
+    std::vector<AtlasFrame> frames;
+    std::vector<AtlasSprite> sprites;
+    int generation = 0;              // manager instance that owns the textures, 0 = none
+};
+inline bool LoadSpriteAtlas(SpriteAtlas& atlas, const char* directory, int pageSize = 2048);
+inline void UnloadSpriteAtlas(SpriteAtlas& atlas);
+inline int FindSprite(const SpriteAtlas& atlas, const char* name); // case-insensitive, -1 if missing
+// Frames wrap, so an ever-increasing animation counter can be passed straight in
+inline void DrawSprite(const SpriteAtlas& atlas, int spriteId, int frame, const Point2f& topLeft, Colour tint = cWhite);
+
+// Present hook: called by PresentDrawingBuffer with the finished frame, after its texture mode has
+// ended and before it is shown. Lets tools such as frame capture see every frame. nullptr disables it.
+typedef void (*PresentHook)(const RenderTexture2D& frame);
+inline void SetPresentHook(PresentHook hook);
 
 // -------------------------
 // Internal Details
 // -------------------------
+// inline (not static) so every translation unit shares one copy
 namespace Internal {
-    static int g_displayWidth = 0;
-    static int g_displayHeight = 0;
-    static int g_displayScale = 1;
-    static RenderTexture2D g_renderTexture;
-    static bool g_textureInitialized = false;
+    inline int g_displayWidth = 0;
+    inline int g_displayHeight = 0;
+    inline int g_displayScale = 1;
+    inline RenderTexture2D g_renderTexture;
+    inline bool g_textureInitialized = false;
+    inline int g_managerGeneration = 0; // bumped per CreateManager so layers from a closed window are ignored
+    inline bool g_inFrame = false;      // between ClearDrawingBuffer and PresentDrawingBuffer
+    inline PresentHook g_presentHook = nullptr;
+
+    // Circle batching: DrawCircle only records, FlushCircles submits every pending circle in one
+    // rlBegin/rlEnd run from meshes tessellated once per radius. Every other draw call flushes
+    // first, so painter's order is unchanged.
+    struct CircleInstance {
+        Vector2 center;
+        int radius;
+        Colour colour;
+    };
+    inline std::vector<CircleInstance> g_circleBatch;
+    inline std::vector<std::vector<Vector2>> g_circleMeshes; // rim points per radius, first point repeated at the end
+
+    inline const std::vector<Vector2>& CircleMesh(int radius);
+    inline void FlushCircles();
+
+    // Sprite batching, as for circles; each instance already holds its page texture and uvs
+    struct SpriteInstance {
+        unsigned int texture;
+        Rectangle dest;
+        float u0, v0, u1, v1;
+        Colour colour;
+    };
+    inline std::vector<SpriteInstance> g_spriteBatch;
+
+    inline void FlushSprites();
+    // Only one batch is ever pending: drawing into one flushes the other
+    inline void FlushBatches();
+
+    // Places rects on shelves, tallest first, opening pages as needed. A rect bigger than a page
+    // opens an oversized page. Returns each page's used size.
+    struct PackRect {
+        int width, height;
+        int page = 0, x = 0, y = 0;
+    };
+    inline std::vector<Vector2> PackRects(std::vector<PackRect>& rects, int pageSize, int padding);
+    inline void ReadFrameCounts(const std::string& name, int& hCount, int& vCount);
+
+    // Text cache: each (string, size) is drawn once in white by DrawText itself into a render texture,
+    // so the glyphs match uncached text exactly, then drawn as one tinted quad. Meant for the small
+    // fixed set of debug labels and banners; once full, further strings are drawn uncached so
+    // changing text cannot grow it without bound.
+    struct CachedText {
+        std::string text;
+        int fontSize;
+        RenderTexture2D target;
+    };
+    inline std::vector<CachedText> g_textCache;
+    constexpr size_t TEXT_CACHE_CAPACITY = 64;
+
+    inline const CachedText* FindOrCacheText(const char* text, int fontSize);
+    inline void ClearTextCache();
+
+    // Per thread, so parallel headless games never share a target
+    inline thread_local SoftwareTarget* t_softwareTarget = nullptr;
+
+    inline uint8_t NearestPaletteIndex(const SoftwareTarget& target, const Colour& colour);
+    inline void SoftFillSpan(SoftwareTarget& target, int x0, int x1, int y, const Colour& colour);
+    inline void SoftFillRect(SoftwareTarget& target, int x0, int y0, int x1, int y1, const Colour& colour);
+    inline void SoftFillCircle(SoftwareTarget& target, float cx, float cy, int radius, const Colour& colour);
+    inline void SoftDrawImage(SoftwareTarget& target, const Image& image, const Rectangle& source, int x, int y, const Colour& tint);
 }
 
 // -------------------------
@@ -79,9 +220,13 @@ inline void CreateManager(const int displayWidth, const int displayHeight, const
     SetTargetFPS(60);
     Internal::g_renderTexture = LoadRenderTexture(displayWidth, displayHeight);
     Internal::g_textureInitialized = true;
+    ++Internal::g_managerGeneration;
 }
 
 inline void DestroyManager() {
+    Internal::g_circleBatch.clear();
+    Internal::g_spriteBatch.clear();
+    Internal::ClearTextCache();
     if (Internal::g_textureInitialized) {
         UnloadRenderTexture(Internal::g_renderTexture);
         Internal::g_textureInitialized = false;
@@ -93,13 +238,26 @@ inline bool KeyDown(const int key) {
     return IsKeyDown(key);
 }
 
+inline bool KeyPressed(const int key) {
+    return IsKeyPressed(key);
+}
+
 inline void ClearDrawingBuffer(const Colour& colour) {
+    if (SoftwareTarget* target = Internal::t_softwareTarget) {
+        Internal::SoftFillRect(*target, 0, 0, target->width - 1, target->height - 1, { colour.r, colour.g, colour.b, 255 });
+        return;
+    }
     BeginTextureMode(Internal::g_renderTexture);
     ClearBackground(colour);
+    Internal::g_inFrame = true;
 }
 
 inline void PresentDrawingBuffer() {
+    if (Internal::t_softwareTarget) return; // the caller owns the pixels
+    Internal::FlushBatches();
+    Internal::g_inFrame = false;
     EndTextureMode();
+    if (Internal::g_presentHook) Internal::g_presentHook(Internal::g_renderTexture);
     BeginDrawing();
     ClearBackground(BLACK);
     const Rectangle source{ 0, 0, static_cast<float>(Internal::g_displayWidth), -static_cast<float>(Internal::g_displayHeight) };
@@ -113,20 +271,499 @@ inline void DrawRect(const Point2f& topLeft, const Point2f& bottomRight, const C
     const int y = static_cast<int>(topLeft.y);
     const int w = static_cast<int>(bottomRight.x - topLeft.x + 1);
     const int h = static_cast<int>(bottomRight.y - topLeft.y + 1);
+    if (SoftwareTarget* target = Internal::t_softwareTarget) {
+        if (filled) {
+            Internal::SoftFillRect(*target, x, y, x + w - 1, y + h - 1, colour);
+        } else {
+            Internal::SoftFillRect(*target, x, y, x + w - 1, y, colour);
+            Internal::SoftFillRect(*target, x, y + h - 1, x + w - 1, y + h - 1, colour);
+            Internal::SoftFillRect(*target, x, y + 1, x, y + h - 2, colour);
+            Internal::SoftFillRect(*target, x + w - 1, y + 1, x + w - 1, y + h - 2, colour);
+        }
+        return;
+    }
+    Internal::FlushBatches();
     if (filled) DrawRectangle(x, y, w, h, colour);
     else        DrawRectangleLines(x, y, w, h, colour);
 }
 
 inline void DrawCircle(const Point2f& center, int radius, const Colour& colour) {
-    DrawCircleV(static_cast<Vector2>(center), static_cast<float>(radius), colour);
+    if (radius <= 0) return;
+    if (SoftwareTarget* target = Internal::t_softwareTarget) {
+        Internal::SoftFillCircle(*target, center.x, center.y, radius, colour);
+        return;
+    }
+    Internal::FlushSprites();
+    Internal::g_circleBatch.push_back({ static_cast<Vector2>(center), radius, colour });
+}
+
+inline const std::vector<Vector2>& Internal::CircleMesh(const int radius) {
+    if (static_cast<int>(g_circleMeshes.size()) <= radius) g_circleMeshes.resize(radius + 1);
+    std::vector<Vector2>& mesh = g_circleMeshes[radius];
+    if (mesh.empty()) {
+        // Same error bound raylib uses to pick a segment count, capped at DrawCircleV's 36
+        const float r = static_cast<float>(radius);
+        const float th = std::acos(2.0f * std::pow(1.0f - 0.5f / r, 2.0f) - 1.0f);
+        int segments = (radius > 1) ? static_cast<int>(std::ceil(2.0f * PI / th)) : 8;
+        segments = segments < 8 ? 8 : (segments > 36 ? 36 : segments);
+        mesh.reserve(segments + 1);
+        for (int i = 0; i <= segments; ++i) {
+            const float a = 2.0f * PI * static_cast<float>(i % segments) / static_cast<float>(segments);
+            mesh.push_back({ std::cos(a) * r, std::sin(a) * r });
+        }
+    }
+    return mesh;
+}
+
+inline void Internal::FlushCircles() {
+    if (g_circleBatch.empty()) return;
+    rlBegin(RL_TRIANGLES);
+    for (const CircleInstance& c : g_circleBatch) {
+        const std::vector<Vector2>& mesh = CircleMesh(c.radius);
+        const int segments = static_cast<int>(mesh.size()) - 1;
+        rlCheckRenderBatchLimit(3 * segments);
+        rlColor4ub(c.colour.r, c.colour.g, c.colour.b, c.colour.a);
+        // Same winding as DrawCircleSector so back-face culling keeps them
+        for (int i = 0; i < segments; ++i) {
+            rlVertex2f(c.center.x, c.center.y);
+            rlVertex2f(c.center.x + mesh[i + 1].x, c.center.y + mesh[i + 1].y);
+            rlVertex2f(c.center.x + mesh[i].x, c.center.y + mesh[i].y);
+        }
+    }
+    rlEnd();
+    g_circleBatch.clear(); // keeps capacity, so steady-state frames don't allocate
+}
+
+inline void Internal::FlushSprites() {
+    if (g_spriteBatch.empty()) return;
+    size_t i = 0;
+    while (i < g_spriteBatch.size()) {
+        // One run per page: a single texture bind for every consecutive sprite on it
+        const unsigned int texture = g_spriteBatch[i].texture;
+        rlSetTexture(texture);
+        rlBegin(RL_QUADS);
+        for (; i < g_spriteBatch.size() && g_spriteBatch[i].texture == texture; ++i) {
+            const SpriteInstance& s = g_spriteBatch[i];
+            rlCheckRenderBatchLimit(4);
+            rlColor4ub(s.colour.r, s.colour.g, s.colour.b, s.colour.a);
+            // Same corner order as DrawTexturePro
+            rlTexCoord2f(s.u0, s.v0);
+            rlVertex2f(s.dest.x, s.dest.y);
+            rlTexCoord2f(s.u0, s.v1);
+            rlVertex2f(s.dest.x, s.dest.y + s.dest.height);
+            rlTexCoord2f(s.u1, s.v1);
+            rlVertex2f(s.dest.x + s.dest.width, s.dest.y + s.dest.height);
+            rlTexCoord2f(s.u1, s.v0);
+            rlVertex2f(s.dest.x + s.dest.width, s.dest.y);
+        }
+        rlEnd();
+    }
+    rlSetTexture(0);
+    g_spriteBatch.clear();
 }
 
-inline void DrawDebugText(const Point2f& pos, const char* text, int fontSize = 20, Colour col = cWhite)
+inline void Internal::FlushBatches() {
+    FlushCircles();
+    FlushSprites();
+}
+
+inline const Internal::CachedText* Internal::FindOrCacheText(const char* text, const int fontSize) {
+    for (const CachedText& entry : g_textCache) {
+        if (entry.fontSize == fontSize && std::strcmp(entry.text.c_str(), text) == 0) return &entry;
+    }
+    if (!g_textureInitialized || g_textCache.size() >= TEXT_CACHE_CAPACITY || text[0] == '\0') return nullptr;
+
+    // DrawText draws sizes under the default font's 10 pixels at 10
+    const int width = MeasureText(text, fontSize);
+    const int height = std::max(fontSize, 10);
+    if (width <= 0) return nullptr;
+    const RenderTexture2D target = LoadRenderTexture(width, height);
+    if (target.id == 0) return nullptr;
+
+    FlushBatches();
+    BeginTextureMode(target);
+    ClearBackground(cTransparent);
+    DrawText(text, 0, 0, fontSize, WHITE);
+    EndTextureMode();
+    // raylib does not nest texture modes, so resume the frame if one was in progress
+    if (g_inFrame) BeginTextureMode(g_renderTexture);
+
+    g_textCache.push_back({ text, fontSize, target });
+    return &g_textCache.back();
+}
+
+inline void Internal::ClearTextCache() {
+    if (g_textureInitialized) {
+        for (const CachedText& entry : g_textCache) UnloadRenderTexture(entry.target);
+    }
+    g_textCache.clear();
+}
+
+inline void DrawDebugText(const Point2f& pos, const char* text, int fontSize, Colour col)
 {
+    if (Internal::t_softwareTarget || text[0] == '\0') return;
+    Internal::FlushBatches();
+    if (const Internal::CachedText* cached = Internal::FindOrCacheText(text, fontSize)) {
+        const Texture2D& texture = cached->target.texture;
+        const int x = static_cast<int>(pos.x - static_cast<float>(texture.width) / 2);
+        const int y = static_cast<int>(pos.y - static_cast<float>(fontSize) / 2);
+        // Render textures are stored bottom-up
+        const Rectangle source{ 0, 0, static_cast<float>(texture.width), -static_cast<float>(texture.height) };
+        DrawTextureRec(texture, source, { static_cast<float>(x), static_cast<float>(y) }, col);
+        return;
+    }
+
     const int textWidth = MeasureText(text, fontSize);
     const int x = static_cast<int>(pos.x - static_cast<float>(textWidth) / 2);
     const int y = static_cast<int>(pos.y - static_cast<float>(fontSize) / 2);
     DrawText(text, x, y, fontSize, col);
 }
 
-} // namespace Play
\ No newline at end of file
+inline bool CreateLayer(Layer& layer, const int width, const int height) {
+    DestroyLayer(layer);
+    if (!Internal::g_textureInitialized || Internal::t_softwareTarget) return false;
+    layer.target = LoadRenderTexture(width, height);
+    if (layer.target.id == 0) return false;
+    layer.generation = Internal::g_managerGeneration;
+    // Start transparent so only what gets drawn shows through
+    BeginLayer(layer);
+    ClearBackground(cTransparent);
+    EndLayer();
+    return true;
+}
+
+inline void DestroyLayer(Layer& layer) {
+    // Textures from a window that has since closed went with its GL context
+    if (IsLayerValid(layer)) UnloadRenderTexture(layer.target);
+    layer = Layer{};
+}
+
+inline bool IsLayerValid(const Layer& layer) {
+    return !Internal::t_softwareTarget && Internal::g_textureInitialized && layer.generation == Internal::g_managerGeneration && layer.target.id != 0;
+}
+
+inline void BeginLayer(const Layer& layer) {
+    Internal::FlushBatches();
+    BeginTextureMode(layer.target);
+}
+
+inline void EndLayer() {
+    Internal::FlushBatches();
+    EndTextureMode();
+    // raylib does not nest texture modes, so resume the frame if one was in progress
+    if (Internal::g_inFrame) BeginTextureMode(Internal::g_renderTexture);
+}
+
+// Overwrites a region of the current target, alpha included (DrawRect would blend).
+// Used to punch holes back into cached layers.
+inline void ClearRect(const Point2f& topLeft, const Point2f& bottomRight, const Colour& colour) {
+    const int x = static_cast<int>(topLeft.x);
+    const int y = static_cast<int>(topLeft.y);
+    if (SoftwareTarget* target = Internal::t_softwareTarget) {
+        // Writes colour as-is; SoftFillRect would blend a translucent one
+        for (int row = std::max(y, 0); row <= std::min(static_cast<int>(bottomRight.y), target->height - 1); ++row) {
+            Internal::SoftFillSpan(*target, x, static_cast<int>(bottomRight.x), row, colour);
+        }
+        return;
+    }
+    Internal::FlushBatches();
+    BeginScissorMode(x, y, static_cast<int>(bottomRight.x) - x + 1, static_cast<int>(bottomRight.y) - y + 1);
+    ClearBackground(colour);
+    EndScissorMode();
+}
+
+inline void DrawLayer(const Layer& layer, const Point2f& topLeft) {
+    Internal::FlushBatches();
+    // Render textures are stored bottom-up
+    const Rectangle source{ 0, 0, static_cast<float>(layer.target.texture.width), -static_cast<float>(layer.target.texture.height) };
+    DrawTextureRec(layer.target.texture, source, static_cast<Vector2>(topLeft), WHITE);
+}
+
+inline bool LoadSpriteAtlas(SpriteAtlas& atlas, const char* directory, const int pageSize) {
+    UnloadSpriteAtlas(atlas);
+    if (!DirectoryExists(directory)) return false;
+
+    // Sorted so sprite ids don't depend on directory order
+    std::vector<std::string> files;
+    const FilePathList list = LoadDirectoryFiles(directory);
+    for (unsigned int i = 0; i < list.count; ++i) {
+        if (IsFileExtension(list.paths[i], ".png")) files.emplace_back(list.paths[i]);
+    }
+    UnloadDirectoryFiles(list);
+    std::sort(files.begin(), files.end());
+
+    std::vector<Image> images;
+    std::vector<int> columns; // frames across each image
+    std::vector<Internal::PackRect> rects;
+    for (const std::string& file : files) {
+        Image image = LoadImage(file.c_str());
+        if (image.data == nullptr) continue;
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        AtlasSprite sprite;
+        sprite.name = GetFileNameWithoutExt(file.c_str());
+        for (char& c : sprite.name) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        int hCount = 1, vCount = 1;
+        Internal::ReadFrameCounts(sprite.name, hCount, vCount);
+        sprite.width = image.width / hCount;
+        sprite.height = image.height / vCount;
+        if (sprite.width == 0 || sprite.height == 0) {
+            UnloadImage(image);
+            continue;
+        }
+        sprite.firstFrame = static_cast<int>(rects.size());
+        sprite.frameCount = hCount * vCount;
+        for (int f = 0; f < sprite.frameCount; ++f) rects.push_back({ sprite.width, sprite.height });
+
+        atlas.sprites.push_back(std::move(sprite));
+        images.push_back(image);
+        columns.push_back(hCount);
+    }
+
+    // A pixel of clear space around every frame so filtering never picks up a neighbour
+    const std::vector<Vector2> pageSizes = Internal::PackRects(rects, pageSize, 1);
+    for (const Vector2& size : pageSizes) {
+        atlas.pages.push_back(GenImageColor(static_cast<int>(size.x), static_cast<int>(size.y), BLANK));
+    }
+
+    // Straight copies: ImageDraw would blend into the clear page
+    for (size_t s = 0; s < atlas.sprites.size(); ++s) {
+        const AtlasSprite& sprite = atlas.sprites[s];
+        const Image& image = images[s];
+        const int hCount = columns[s];
+        for (int f = 0; f < sprite.frameCount; ++f) {
+            const Internal::PackRect& rect = rects[sprite.firstFrame + f];
+            const Image& page = atlas.pages[rect.page];
+            const int srcX = (f % hCount) * sprite.width, srcY = (f / hCount) * sprite.height;
+            for (int row = 0; row < sprite.height; ++row) {
+                const uint8_t* src = static_cast<const uint8_t*>(image.data) + (static_cast<size_t>(srcY + row) * image.width + srcX) * 4;
+                uint8_t* dst = static_cast<uint8_t*>(page.data) + (static_cast<size_t>(rect.y + row) * page.width + rect.x) * 4;
+                std::memcpy(dst, src, static_cast<size_t>(sprite.width) * 4);
+            }
+            atlas.frames.push_back({ rect.page, { static_cast<float>(rect.x), static_cast<float>(rect.y), static_cast<float>(sprite.width), static_cast<float>(sprite.height) } });
+        }
+        UnloadImage(image);
+    }
+
+    if (Internal::g_textureInitialized) {
+        for (const Image& page : atlas.pages) atlas.textures.push_back(LoadTextureFromImage(page));
+        atlas.generation = Internal::g_managerGeneration;
+    }
+    return true;
+}
+
+inline void UnloadSpriteAtlas(SpriteAtlas& atlas) {
+    if (Internal::g_textureInitialized && atlas.generation == Internal::g_managerGeneration) {
+        // Pending draws may use these textures, so submit them while they still exist
+        Internal::FlushSprites();
+        rlDrawRenderBatchActive();
+        for (const Texture2D& texture : atlas.textures) UnloadTexture(texture);
+    }
+    for (const Image& page : atlas.pages) UnloadImage(page);
+    atlas = SpriteAtlas{};
+}
+
+inline int FindSprite(const SpriteAtlas& atlas, const char* name) {
+    std::string upper = name;
+    for (char& c : upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    for (size_t i = 0; i < atlas.sprites.size(); ++i) {
+        if (atlas.sprites[i].name == upper) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+inline void DrawSprite(const SpriteAtlas& atlas, const int spriteId, const int frame, const Point2f& topLeft, const Colour tint) {
+    if (spriteId < 0 || spriteId >= static_cast<int>(atlas.sprites.size())) return;
+    const AtlasSprite& sprite = atlas.sprites[spriteId];
+    const int wrapped = ((frame % sprite.frameCount) + sprite.frameCount) % sprite.frameCount;
+    const AtlasFrame& f = atlas.frames[sprite.firstFrame + wrapped];
+
+    if (SoftwareTarget* target = Internal::t_softwareTarget) {
+        Internal::SoftDrawImage(*target, atlas.pages[f.page], f.source, static_cast<int>(topLeft.x), static_cast<int>(topLeft.y), tint);
+        return;
+    }
+    // Textures from a window that has since closed went with its GL context
+    if (!Internal::g_textureInitialized || atlas.generation != Internal::g_managerGeneration) return;
+
+    Internal::FlushCircles();
+    const Texture2D& texture = atlas.textures[f.page];
+    const float w = static_cast<float>(texture.width), h = static_cast<float>(texture.height);
+    Internal::g_spriteBatch.push_back({ texture.id, { topLeft.x, topLeft.y, f.source.width, f.source.height },
+        f.source.x / w, f.source.y / h, (f.source.x + f.source.width) / w, (f.source.y + f.source.height) / h, tint });
+}
+
+inline std::vector<Vector2> Internal::PackRects(std::vector<PackRect>& rects, const int pageSize, const int padding) {
+    struct Shelf {
+        int page, y, height, x;
+    };
+    std::vector<Vector2> pages;
+    std::vector<Shelf> shelves;
+    std::vector<int> pageBottoms; // first free row per page
+
+    std::vector<size_t> order(rects.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&rects](size_t a, size_t b) {
+        return rects[a].height != rects[b].height ? rects[a].height > rects[b].height : rects[a].width > rects[b].width;
+    });
+
+    for (const size_t index : order) {
+        PackRect& rect = rects[index];
+        const int w = rect.width + padding, h = rect.height + padding;
+
+        // First shelf that is tall enough and has room left
+        Shelf* shelf = nullptr;
+        for (Shelf& candidate : shelves) {
+            if (h <= candidate.height && candidate.x + w <= pageSize) { shelf = &candidate; break; }
+        }
+        if (shelf == nullptr) {
+            // Open a shelf at the bottom of the first page with space, or a new page
+            size_t page = 0;
+            while (page < pageBottoms.size() && (pageBottoms[page] + h > pageSize || w > pageSize)) ++page;
+            if (page == pageBottoms.size()) {
+                pageBottoms.push_back(0);
+                pages.push_back({ 0, 0 });
+            }
+            shelves.push_back({ static_cast<int>(page), pageBottoms[page], h, 0 });
+            pageBottoms[page] += h;
+            shelf = &shelves.back();
+        }
+
+        rect.page = shelf->page;
+        rect.x = shelf->x;
+        rect.y = shelf->y;
+        shelf->x += w;
+        Vector2& used = pages[shelf->page];
+        used.x = std::max(used.x, static_cast<float>(rect.x + rect.width));
+        used.y = std::max(used.y, static_cast<float>(rect.y + rect.height));
+    }
+    return pages;
+}
+
+// name_w is w frames across, name_wxh is w across by h down; anything else is a single frame
+inline void Internal::ReadFrameCounts(const std::string& name, int& hCount, int& vCount) {
+    hCount = vCount = 1;
+    const size_t underscore = name.find_last_of('_');
+    if (underscore == std::string::npos || underscore + 1 == name.size()) return;
+
+    const std::string suffix = name.substr(underscore + 1);
+    const size_t x = suffix.find_first_of("xX");
+    const std::string across = suffix.substr(0, x);
+    const std::string down = x == std::string::npos ? "1" : suffix.substr(x + 1);
+    const auto isCount = [](const std::string& digits) {
+        return !digits.empty() && digits.size() < 5 && digits.find_first_not_of("0123456789") == std::string::npos && std::atoi(digits.c_str()) > 0;
+    };
+    if (!isCount(across) || !isCount(down)) return;
+    hCount = std::atoi(across.c_str());
+    vCount = std::atoi(down.c_str());
+}
+
+inline void SetSoftwareTarget(SoftwareTarget* target) {
+    Internal::t_softwareTarget = target;
+}
+
+inline SoftwareTarget* GetSoftwareTarget() {
+    return Internal::t_softwareTarget;
+}
+
+inline void SetPresentHook(PresentHook hook) {
+    Internal::g_presentHook = hook;
+}
+
+// Writes one opaque run [x0, x1] on row y, clipped once for the whole span
+inline void Internal::SoftFillSpan(SoftwareTarget& target, int x0, int x1, const int y, const Colour& colour) {
+    if (y < 0 || y >= target.height) return;
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, target.width - 1);
+    if (x0 > x1) return;
+
+    uint8_t* row = target.pixels + static_cast<size_t>(y) * target.pitch;
+    if (target.format == PixelFormat::RGBA8) {
+        uint32_t packed;
+        static_assert(sizeof(Colour) == sizeof(uint32_t), "Colour must be 4 packed bytes");
+        std::memcpy(&packed, &colour, sizeof(packed));
+        std::fill_n(reinterpret_cast<uint32_t*>(row) + x0, x1 - x0 + 1, packed);
+        return;
+    }
+
+    // Nearest palette entry, resolved once per span rather than per pixel
+    std::fill_n(row + x0, x1 - x0 + 1, NearestPaletteIndex(target, colour));
+}
+
+inline uint8_t Internal::NearestPaletteIndex(const SoftwareTarget& target, const Colour& colour) {
+    int best = 0, bestDist = INT32_MAX;
+    for (int i = 0; i < target.paletteSize; ++i) {
+        const int dr = target.palette[i].r - colour.r, dg = target.palette[i].g - colour.g, db = target.palette[i].b - colour.b;
+        const int dist = dr * dr + dg * dg + db * db;
+        if (dist < bestDist) { bestDist = dist; best = i; }
+    }
+    return static_cast<uint8_t>(best);
+}
+
+inline void Internal::SoftFillRect(SoftwareTarget& target, const int x0, int y0, const int x1, int y1, const Colour& colour) {
+    if (colour.a == 0) return;
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, target.height - 1);
+
+    if (colour.a == 255 || target.format == PixelFormat::Indexed8) {
+        for (int y = y0; y <= y1; ++y) SoftFillSpan(target, x0, x1, y, colour);
+        return;
+    }
+
+    // Translucent source-over blend (RGBA only; the palette path has no destination colour to mix)
+    const int cx0 = std::max(x0, 0), cx1 = std::min(x1, target.width - 1);
+    const int a = colour.a, ia = 255 - a;
+    for (int y = y0; y <= y1; ++y) {
+        uint8_t* p = target.pixels + static_cast<size_t>(y) * target.pitch + static_cast<size_t>(cx0) * 4;
+        for (int x = cx0; x <= cx1; ++x, p += 4) {
+            p[0] = static_cast<uint8_t>((colour.r * a + p[0] * ia) / 255);
+            p[1] = static_cast<uint8_t>((colour.g * a + p[1] * ia) / 255);
+            p[2] = static_cast<uint8_t>((colour.b * a + p[2] * ia) / 255);
+            p[3] = static_cast<uint8_t>(a + p[3] * ia / 255);
+        }
+    }
+}
+
+// Covers every pixel whose centre lies inside the circle, one span per scanline
+inline void Internal::SoftFillCircle(SoftwareTarget& target, const float cx, const float cy, const int radius, const Colour& colour) {
+    const float r = static_cast<float>(radius);
+    const int y0 = static_cast<int>(std::ceil(cy - r - 0.5f));
+    const int y1 = static_cast<int>(std::floor(cy + r - 0.5f));
+    for (int y = y0; y <= y1; ++y) {
+        const float dy = static_cast<float>(y) + 0.5f - cy;
+        const float half = std::sqrt(std::max(r * r - dy * dy, 0.0f));
+        const int x0 = static_cast<int>(std::ceil(cx - half - 0.5f));
+        const int x1 = static_cast<int>(std::floor(cx + half - 0.5f));
+        SoftFillRect(target, x0, y, x1, y, colour);
+    }
+}
+
+// Source-over blit of an RGBA8 image region, modulated by tint. Indexed targets take the nearest
+// palette entry for pixels at least half opaque.
+inline void Internal::SoftDrawImage(SoftwareTarget& target, const Image& image, const Rectangle& source, const int x, const int y, const Colour& tint) {
+    const int srcX = static_cast<int>(source.x), srcY = static_cast<int>(source.y);
+    const int x0 = std::max(x, 0), x1 = std::min(x + static_cast<int>(source.width), target.width);
+    const int y0 = std::max(y, 0), y1 = std::min(y + static_cast<int>(source.height), target.height);
+
+    for (int row = y0; row < y1; ++row) {
+        const uint8_t* src = static_cast<const uint8_t*>(image.data) + (static_cast<size_t>(srcY + row - y) * image.width + srcX + x0 - x) * 4;
+        uint8_t* dst = target.pixels + static_cast<size_t>(row) * target.pitch;
+        for (int col = x0; col < x1; ++col, src += 4) {
+            const int a = src[3] * tint.a / 255;
+            if (a == 0) continue;
+            const Colour c{ static_cast<uint8_t>(src[0] * tint.r / 255), static_cast<uint8_t>(src[1] * tint.g / 255), static_cast<uint8_t>(src[2] * tint.b / 255), static_cast<uint8_t>(a) };
+            if (target.format == PixelFormat::Indexed8) {
+                if (a >= 128) dst[col] = NearestPaletteIndex(target, c);
+                continue;
+            }
+            // Same source-over blend as SoftFillRect
+            uint8_t* p = dst + static_cast<size_t>(col) * 4;
+            const int ia = 255 - a;
+            p[0] = static_cast<uint8_t>((c.r * a + p[0] * ia) / 255);
+            p[1] = static_cast<uint8_t>((c.g * a + p[1] * ia) / 255);
+            p[2] = static_cast<uint8_t>((c.b * a + p[2] * ia) / 255);
+            p[3] = static_cast<uint8_t>(a + p[3] * ia / 255);
+        }
+    }
+}
+
+} // namespace Play
@@ -0,0 +1,68 @@
+#pragma once
+
+// Includes
+#include <atomic>
+#include <cstddef>
+
+// SpscQueue.h
+// Bounded lock-free FIFO for exactly one producer thread and one consumer thread.
+// - Fixed power-of-two capacity stored inline: never allocates after construction
+// - TryPush/TryPop never block; callers choose whether to drop, retry or sleep
+// - Each side caches the other's index, so the shared atomics are only re-read when the
+//   queue looks full (producer) or empty (consumer)
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+	// Producer thread only
+	bool TryPush(const T& item)
+	{
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		if (head - m_tailCache == Capacity)
+		{
+			m_tailCache = m_tail.load(std::memory_order_acquire);
+			if (head - m_tailCache == Capacity)
+			{
+				return false; // full
+			}
+		}
+
+		m_items[head & (Capacity - 1)] = item;
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer thread only
+	bool TryPop(T& item)
+	{
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail == m_headCache)
+		{
+			m_headCache = m_head.load(std::memory_order_acquire);
+			if (tail == m_headCache)
+			{
+				return false; // empty
+			}
+		}
+
+		item = m_items[tail & (Capacity - 1)];
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Snapshot only; exact when called from either end while the other is idle
+	size_t Size() const
+	{
+		return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	// Producer and consumer state on separate cache lines to avoid false sharing
+	alignas(64) std::atomic<size_t> m_head{ 0 };
+	size_t m_tailCache = 0;
+	alignas(64) std::atomic<size_t> m_tail{ 0 };
+	size_t m_headCache = 0;
+	alignas(64) T m_items[Capacity]{};
+};
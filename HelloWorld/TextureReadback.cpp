@@ -0,0 +1,31 @@
+// This file's header
+#include "TextureReadback.h"
+
+// Other includes
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+	#include <GL/gl.h>
+#elif defined(__APPLE__)
+	#define GL_SILENCE_DEPRECATION
+	#include <OpenGL/gl.h>
+#else
+	#include <GL/gl.h>
+#endif
+
+bool ReadTextureRgba8(unsigned int textureId, int width, int height, uint8_t* pixels)
+{
+	if (textureId == 0 || width <= 0 || height <= 0 || !pixels)
+	{
+		return false;
+	}
+
+	// glGetTexImage is GL 1.1, so every desktop GL exports it without a loader. Rows of RGBA8 are
+	// always 4-byte aligned, and the binding is left at 0 the way rlReadTexturePixels leaves it
+	glBindTexture(GL_TEXTURE_2D, textureId);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return true;
+}
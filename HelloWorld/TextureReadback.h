@@ -0,0 +1,11 @@
+#pragma once
+
+// Includes
+#include <cstdint>
+
+// TextureReadback.h
+// Reads an RGBA8 texture back into memory the caller owns, which rlReadTexturePixels can't do: it
+// allocates a new buffer on every call. Kept apart from raylib.h, whose names clash with the
+// platform GL headers. Synchronous: the calling thread waits until the GPU has finished the texture.
+// Needs the window's GL context current on the calling thread; rows come back bottom-up, as GL stores them.
+bool ReadTextureRgba8(unsigned int textureId, int width, int height, uint8_t* pixels);
@@ -0,0 +1,232 @@
+// This file's header
+#include "Trace.h"
+
+// Other includes
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "JsonString.h"
+#include "SpscQueue.h"
+
+#pragma region Helpers
+namespace {
+
+	struct TraceEvent
+	{
+		uint64_t ns = 0; // since Start
+		const char* category = nullptr;
+		const char* name = nullptr;
+		const char* argNames[2] = {};
+		const char* argValues[2] = {};
+		char phase = 'i';  // 'B' begin, 'E' end, 'i' instant
+	};
+
+	// Drained every FLUSH_INTERVAL, so only a burst of thousands of events in one interval can fill it
+	constexpr size_t BUFFER_EVENTS = 4096;
+	constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(20);
+
+	// Producer: the owning thread. Consumer: the flush thread (or Start/Stop while it is not running).
+	struct ThreadBuffer
+	{
+		SpscQueue<TraceEvent, BUFFER_EVENTS> events;
+		uint32_t tid = 0;
+	};
+
+	// Buffers live until exit, so a thread that finishes early never leaves a dangling pointer behind
+	std::mutex s_registryMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+	std::vector<ThreadBuffer*> s_drainList; // Drain's copy of the registry, reused so draining doesn't allocate
+
+	thread_local ThreadBuffer* t_buffer = nullptr;
+
+	std::atomic<bool> s_active{ false };
+	std::atomic<uint64_t> s_dropped{ 0 };
+	std::chrono::steady_clock::time_point s_origin;
+	FILE* s_file = nullptr;
+	bool s_firstEvent = true;
+	std::thread s_flusher;
+
+	ThreadBuffer& LocalBuffer()
+	{
+		if (!t_buffer)
+		{
+			const std::lock_guard<std::mutex> lock(s_registryMutex);
+			s_buffers.push_back(std::make_unique<ThreadBuffer>());
+			t_buffer = s_buffers.back().get();
+			t_buffer->tid = static_cast<uint32_t>(s_buffers.size());
+		}
+		return *t_buffer;
+	}
+
+	void Record(TraceEvent& event)
+	{
+		if (!s_active.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		event.ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - s_origin).count());
+		if (!LocalBuffer().events.TryPush(event))
+		{
+			s_dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void WriteEvent(const TraceEvent& e, uint32_t tid)
+	{
+		std::fprintf(s_file, "%s{\"name\":", s_firstEvent ? "" : ",\n");
+		WriteJsonString(s_file, e.name);
+		std::fprintf(s_file, ",\"cat\":");
+		WriteJsonString(s_file, e.category);
+		std::fprintf(s_file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u", e.phase, e.ns / 1000.0, tid);
+		s_firstEvent = false;
+
+		if (e.phase == 'i')
+		{
+			std::fprintf(s_file, ",\"s\":\"t\"");
+		}
+
+		for (int i = 0; i < 2 && e.argNames[i]; ++i)
+		{
+			std::fprintf(s_file, i == 0 ? ",\"args\":{" : ",");
+			WriteJsonString(s_file, e.argNames[i]);
+			std::fputc(':', s_file);
+			WriteJsonString(s_file, e.argValues[i] ? e.argValues[i] : "");
+		}
+		if (e.argNames[0])
+		{
+			std::fprintf(s_file, "}");
+		}
+		std::fprintf(s_file, "}");
+	}
+
+	// Only ever runs on one thread at a time: the flusher, or the caller of Start/Stop while it is joined.
+	// The lock is held just to copy the registry, so a thread registering its first event never waits on the file.
+	void Drain(bool write)
+	{
+		{
+			const std::lock_guard<std::mutex> lock(s_registryMutex);
+			s_drainList.clear();
+			for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+			{
+				s_drainList.push_back(buffer.get());
+			}
+		}
+
+		TraceEvent event;
+		for (ThreadBuffer* buffer : s_drainList)
+		{
+			while (buffer->events.TryPop(event))
+			{
+				if (write)
+				{
+					WriteEvent(event, buffer->tid);
+				}
+			}
+		}
+	}
+
+	void FlushLoop()
+	{
+		while (s_active.load(std::memory_order_acquire))
+		{
+			std::this_thread::sleep_for(FLUSH_INTERVAL);
+			Drain(true);
+		}
+	}
+
+}
+#pragma endregion
+
+namespace Tracing
+{
+	bool Start(const char* path)
+	{
+		if (IsActive())
+		{
+			return true;
+		}
+
+		s_file = std::fopen(path, "w");
+		if (!s_file)
+		{
+			return false;
+		}
+
+		// Anything recorded while a previous trace was stopping belongs to no file
+		Drain(false);
+
+		std::fprintf(s_file, "[\n");
+		s_firstEvent = true;
+		s_dropped = 0;
+		s_origin = std::chrono::steady_clock::now();
+		s_active.store(true, std::memory_order_release);
+		s_flusher = std::thread(FlushLoop);
+		return true;
+	}
+
+	void Stop()
+	{
+		if (!IsActive())
+		{
+			return;
+		}
+
+		s_active.store(false, std::memory_order_release);
+		s_flusher.join();
+		Drain(true);
+
+		std::fprintf(s_file, "\n]\n");
+		std::fclose(s_file);
+		s_file = nullptr;
+	}
+
+	bool IsActive()
+	{
+		return s_active.load(std::memory_order_acquire);
+	}
+
+	uint64_t GetDroppedCount()
+	{
+		return s_dropped.load(std::memory_order_relaxed);
+	}
+
+	void Begin(const char* category, const char* name)
+	{
+		TraceEvent event;
+		event.category = category;
+		event.name = name;
+		event.phase = 'B';
+		Record(event);
+	}
+
+	void End(const char* category, const char* name)
+	{
+		TraceEvent event;
+		event.category = category;
+		event.name = name;
+		event.phase = 'E';
+		Record(event);
+	}
+
+	void Instant(const char* category, const char* name,
+		const char* argName0, const char* argValue0,
+		const char* argName1, const char* argValue1)
+	{
+		TraceEvent event;
+		event.category = category;
+		event.name = name;
+		event.argNames[0] = argName0;
+		event.argValues[0] = argValue0;
+		event.argNames[1] = argName1;
+		event.argValues[1] = argValue1;
+		event.phase = 'i';
+		Record(event);
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// Includes
+#include <cstdint>
+
+// Trace.h
+// Timeline events exported as Chrome trace-event JSON (open in Perfetto UI or chrome://tracing).
+// - Each thread records into its own lock-free buffer; recording never blocks or allocates
+//   (apart from the first event on a thread, which registers its buffer)
+// - A background thread drains the buffers into the file while the game runs
+// - If a buffer fills faster than it is drained, events are dropped and counted
+// Names, categories and argument strings are stored by pointer, so they must be string literals
+// (or otherwise outlive the trace). They are escaped as the file is written.
+// The TRACE_* macros compile to nothing unless PACMAN_ENABLE_TRACING is defined (CMake option of the same name).
+
+namespace Tracing
+{
+	bool Start(const char* path);
+
+	// Drains everything recorded so far, closes the JSON array and the file
+	void Stop();
+
+	bool IsActive();
+	uint64_t GetDroppedCount();
+
+	// Duration events must nest per thread, as in the trace-event format
+	void Begin(const char* category, const char* name);
+	void End(const char* category, const char* name);
+
+	// Thread-scoped instant with up to two string arguments
+	void Instant(const char* category, const char* name,
+		const char* argName0 = nullptr, const char* argValue0 = nullptr,
+		const char* argName1 = nullptr, const char* argValue1 = nullptr);
+}
+
+#ifdef PACMAN_ENABLE_TRACING
+	#define TRACE_BEGIN(category, name) Tracing::Begin(category, name)
+	#define TRACE_END(category, name) Tracing::End(category, name)
+	#define TRACE_INSTANT(...) Tracing::Instant(__VA_ARGS__)
+#else
+	#define TRACE_BEGIN(category, name) ((void)0)
+	#define TRACE_END(category, name) ((void)0)
+	#define TRACE_INSTANT(...) ((void)0)
+#endif
@@ -20,6 +20,7 @@ struct Cfg
         // Ghost speed multipliers
         static constexpr float FRIGHTENED_SPEED_MULT = 0.7f;
         static constexpr float EATEN_SPEED_MULT = 1.6f;
+        static constexpr float TUNNEL_SPEED_MULT = 0.5f;
         static constexpr float BASE_GHOST_SPEED = 80.0f;
 
         // Pacman speed
@@ -44,7 +45,8 @@ enum class TileType {
         WALL,
         EMPTY,
         PELLET,
-        POWERUP
+        POWERUP,
+        TUNNEL // empty, slows ghosts; on the board edge it is a portal to the opposite edge
 };
 
 inline Play::Point2f CenterOf(const int gx, const int gy)
@@ -0,0 +1,288 @@
+// Includes
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AudioMixer.h"
+#include "TestCommon.h"
+
+// AudioMixerTest.cpp
+// Checks the mixer's output sample by sample, with no audio device: the mixer is started with openDevice off and
+// the test mixes callback-sized blocks itself while the streamer thread runs as it does in the game. The WAVs are
+// written by the test, short ones to be loaded and long ones (over the threshold) to be streamed.
+// - Streamed tracks at the mixer rate come out bit for bit: one-shots whose length isn't a multiple of the chunk
+//   size and ones that end exactly on a chunk boundary, mono ones, loops, and a track restarted part way through;
+//   with no underruns
+// - Commands: the gain clamp and 4.12 rounding, saturation, which voice is stolen when the pool is full (the oldest
+//   one-shot, else the oldest loop), and that commands beyond the queue's depth are counted as dropped
+
+#pragma region Helpers
+namespace {
+
+	namespace fs = std::filesystem;
+
+	constexpr int RATE = 44100;
+	constexpr unsigned int BLOCK = 512;     // frames per "callback"
+	constexpr size_t CHUNK = 4096;          // AudioMixer.cpp's STREAM_CHUNK_FRAMES
+	constexpr int VOICES = 16;              // AudioMixer.cpp's VOICE_COUNT
+	constexpr int QUEUE_DEPTH = 64;         // AudioMixer.cpp's QUEUE_DEPTH
+	constexpr size_t THRESHOLD = 20000;     // bytes: the short sound is loaded, the tracks streamed
+	constexpr int16_t DC = 1000;            // the short sound: +DC on the left, -DC on the right
+
+	void WriteWav(const fs::path& path, int channels, const std::vector<int16_t>& samples)
+	{
+		const uint32_t dataBytes = static_cast<uint32_t>(samples.size() * 2);
+		const uint32_t riffBytes = 36 + dataBytes, fmtBytes = 16, rate = RATE, byteRate = RATE * channels * 2;
+		const uint16_t format = 1, channelCount = static_cast<uint16_t>(channels), align = static_cast<uint16_t>(channels * 2), bits = 16;
+
+		FILE* file = std::fopen(path.string().c_str(), "wb");
+		std::fwrite("RIFF", 1, 4, file);
+		std::fwrite(&riffBytes, 4, 1, file);
+		std::fwrite("WAVEfmt ", 1, 8, file);
+		std::fwrite(&fmtBytes, 4, 1, file);
+		std::fwrite(&format, 2, 1, file);
+		std::fwrite(&channelCount, 2, 1, file);
+		std::fwrite(&rate, 4, 1, file);
+		std::fwrite(&byteRate, 4, 1, file);
+		std::fwrite(&align, 2, 1, file);
+		std::fwrite(&bits, 2, 1, file);
+		std::fwrite("data", 1, 4, file);
+		std::fwrite(&dataBytes, 4, 1, file);
+		std::fwrite(samples.data(), 2, samples.size(), file);
+		std::fclose(file);
+	}
+
+	// Never zero, so where a track starts and stops can be read off the output
+	std::vector<int16_t> TrackSamples(size_t count, int seed)
+	{
+		std::vector<int16_t> samples(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			const int value = 1 + static_cast<int>((i * 7919 + seed * 104729) % 30000);
+			samples[i] = static_cast<int16_t>(i % 2 ? -value : value);
+		}
+		return samples;
+	}
+
+	// Mixes blocks until `frames` frames are collected. The first block applies what was queued; the streamer is
+	// then given time to fill both chunks, and a little time per block after that (under real time, a block lasts
+	// 11.6 ms), so any gap in a track is the mixer's fault
+	std::vector<int16_t> Render(size_t frames)
+	{
+		std::vector<int16_t> out;
+		std::vector<int16_t> block(BLOCK * 2);
+		while (out.size() < frames * 2)
+		{
+			Mixer::Mix(block.data(), BLOCK);
+			out.insert(out.end(), block.begin(), block.end());
+			std::this_thread::sleep_for(std::chrono::milliseconds(out.size() == BLOCK * 2 ? 30 : 2));
+		}
+		return out;
+	}
+
+	// The output must be silence, the track's frames `plays` times over (stereo, or mono on both channels), then
+	// silence. `plays` 0 means a loop stopped after at least two plays, -1 a track still playing when the output ends.
+	bool PlayedExactly(const std::vector<int16_t>& out, const std::vector<int16_t>& track, int channels, int plays)
+	{
+		const size_t trackFrames = track.size() / channels;
+		size_t frame = 0;
+		const size_t outFrames = out.size() / 2;
+		while (frame < outFrames && out[frame * 2] == 0 && out[frame * 2 + 1] == 0)
+		{
+			frame++;
+		}
+
+		size_t played = 0;
+		for (; frame < outFrames && (out[frame * 2] != 0 || out[frame * 2 + 1] != 0); frame++, played++)
+		{
+			const size_t source = (played % trackFrames) * channels;
+			if (out[frame * 2] != track[source] || out[frame * 2 + 1] != track[source + channels - 1])
+			{
+				std::printf("frame %zu of the track differs\n", played);
+				return false;
+			}
+		}
+		for (; frame < outFrames; frame++)
+		{
+			if (out[frame * 2] != 0 || out[frame * 2 + 1] != 0)
+			{
+				std::printf("sound after the track ended, %zu frames in\n", played);
+				return false;
+			}
+		}
+
+		const bool lengthRight = plays > 0 ? played == trackFrames * plays : (plays == 0 ? played >= trackFrames * 2 : played > 0);
+		if (!lengthRight)
+		{
+			std::printf("%zu frames of the track played, of %zu\n", played, trackFrames);
+			return false;
+		}
+		return true;
+	}
+
+	// Mixes one block, which must be the same left and right values throughout
+	bool BlockIs(int left, int right)
+	{
+		std::vector<int16_t> block(BLOCK * 2);
+		Mixer::Mix(block.data(), BLOCK);
+		for (unsigned int i = 0; i < BLOCK; i++)
+		{
+			if (block[i * 2] != left || block[i * 2 + 1] != right)
+			{
+				std::printf("frame %u is %d, %d rather than %d, %d\n", i, block[i * 2], block[i * 2 + 1], left, right);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	AudioMixerStats Since(const AudioMixerStats& before)
+	{
+		AudioMixerStats now = Mixer::GetStats();
+		now.played -= before.played;
+		now.stolen -= before.stolen;
+		now.dropped -= before.dropped;
+		now.underruns -= before.underruns;
+		return now;
+	}
+
+}
+#pragma endregion
+
+int main()
+{
+	const fs::path directory = fs::temp_directory_path() / "PacmanAudioMixerTest";
+	fs::remove_all(directory);
+	fs::create_directories(directory);
+
+	std::vector<int16_t> dc(CHUNK * 2);
+	for (size_t i = 0; i < dc.size(); i++)
+	{
+		dc[i] = i % 2 ? -DC : DC;
+	}
+	const std::vector<int16_t> track = TrackSamples((3 * CHUNK + 1000) * 2, 1);
+	const std::vector<int16_t> exact = TrackSamples(2 * CHUNK * 2, 2);
+	const std::vector<int16_t> mono = TrackSamples(3 * CHUNK + 77, 3);
+	WriteWav(directory / "dc.wav", 2, dc);
+	WriteWav(directory / "track.wav", 2, track);
+	WriteWav(directory / "exact.wav", 2, exact);
+	WriteWav(directory / "mono.wav", 1, mono);
+
+	AudioMixerSettings settings;
+	settings.directory = directory.string();
+	settings.sampleRate = RATE;
+	settings.streamThresholdBytes = THRESHOLD;
+	settings.openDevice = false;
+	TEST_CHECK(Mixer::Start(settings));
+	const SoundId dcSound = Mixer::FindSound("DC.wav");
+	const SoundId trackSound = Mixer::FindSound("track");
+	const SoundId exactSound = Mixer::FindSound("exact");
+	const SoundId monoSound = Mixer::FindSound("mono");
+	TEST_CHECK(dcSound != INVALID_SOUND && trackSound != INVALID_SOUND && exactSound != INVALID_SOUND && monoSound != INVALID_SOUND);
+
+	// Streamed tracks, bit for bit
+	const AudioMixerStats streamStart = Mixer::GetStats();
+	Mixer::PlaySound(trackSound);
+	TEST_CHECK(PlayedExactly(Render(track.size() / 2 + 2 * CHUNK), track, 2, 1));
+
+	Mixer::PlaySound(exactSound);
+	TEST_CHECK(PlayedExactly(Render(exact.size() / 2 + 2 * CHUNK), exact, 2, 1));
+
+	Mixer::PlaySound(monoSound);
+	TEST_CHECK(PlayedExactly(Render(mono.size() + 2 * CHUNK), mono, 1, 1));
+
+	const VoiceId loop = Mixer::PlaySound(trackSound, true);
+	std::vector<int16_t> looped = Render(track.size() + CHUNK);
+	Mixer::StopVoice(loop);
+	const std::vector<int16_t> afterStop = Render(2 * BLOCK);
+	looped.insert(looped.end(), afterStop.begin(), afterStop.end());
+	TEST_CHECK(PlayedExactly(looped, track, 2, 0));
+
+	// Restarted part way through its second chunk: the rest of the first play is cut, and the track plays once
+	// from the start on the same voice (a second voice would add to it)
+	Mixer::PlaySound(trackSound);
+	const std::vector<int16_t> partial = Render(CHUNK + CHUNK / 2);
+	Mixer::PlaySound(trackSound);
+	const std::vector<int16_t> restarted = Render(track.size() / 2 + 2 * CHUNK);
+	TEST_CHECK(PlayedExactly(partial, track, 2, -1));
+	TEST_CHECK(PlayedExactly(restarted, track, 2, 1));
+
+	const AudioMixerStats streamed = Since(streamStart);
+	TEST_CHECK(streamed.underruns == 0 && streamed.stolen == 0 && streamed.dropped == 0 && streamed.played == 6);
+
+	// Gain: 4.12 fixed point, clamped to [0, 4], summed and saturated
+	Mixer::PlaySound(dcSound, false, 0.5f);
+	TEST_CHECK(BlockIs(DC / 2, -DC / 2));
+	Mixer::StopSound(dcSound);
+	Mixer::PlaySound(dcSound, false, 10.0f);
+	TEST_CHECK(BlockIs(DC * 4, -DC * 4));
+	Mixer::StopSound(dcSound);
+	Mixer::PlaySound(dcSound, false, -3.0f);
+	TEST_CHECK(BlockIs(0, 0));
+	Mixer::StopSound(dcSound);
+	Mixer::PlaySound(dcSound, false, 1.0f / 3.0f);
+	TEST_CHECK(BlockIs((DC * 1365) >> 12, (-DC * 1365) >> 12));
+	Mixer::StopSound(dcSound);
+	for (int n = 0; n < 9; n++)
+	{
+		Mixer::PlaySound(dcSound, false, 4.0f);
+	}
+	TEST_CHECK(BlockIs(32767, -32768));
+	Mixer::StopSound(dcSound);
+	TEST_CHECK(BlockIs(0, 0));
+
+	// A full pool with a loop in it: the oldest one-shot goes, not the older loop
+	const AudioMixerStats stealStart = Mixer::GetStats();
+	const VoiceId loud = Mixer::PlaySound(dcSound, true, 1.0f);
+	std::vector<VoiceId> quiet;
+	for (int n = 0; n < VOICES; n++)
+	{
+		quiet.push_back(Mixer::PlaySound(dcSound, false, 0.25f));
+	}
+	TEST_CHECK(BlockIs(DC + 15 * DC / 4, -DC - 15 * DC / 4));
+	Mixer::StopVoice(quiet[0]);
+	TEST_CHECK(BlockIs(DC + 15 * DC / 4, -DC - 15 * DC / 4));
+	Mixer::StopVoice(quiet[1]);
+	TEST_CHECK(BlockIs(DC + 14 * DC / 4, -DC - 14 * DC / 4));
+	Mixer::StopVoice(loud);
+	TEST_CHECK(BlockIs(14 * DC / 4, -14 * DC / 4));
+	Mixer::StopSound(dcSound);
+
+	// A pool full of loops: the oldest loop goes
+	std::vector<VoiceId> loops;
+	for (int n = 0; n < VOICES; n++)
+	{
+		loops.push_back(Mixer::PlaySound(dcSound, true, 0.25f));
+	}
+	Mixer::PlaySound(dcSound, true, 1.0f);
+	TEST_CHECK(BlockIs(DC + 15 * DC / 4, -DC - 15 * DC / 4));
+	Mixer::StopVoice(loops[0]);
+	TEST_CHECK(BlockIs(DC + 15 * DC / 4, -DC - 15 * DC / 4));
+	Mixer::StopVoice(loops[1]);
+	TEST_CHECK(BlockIs(DC + 14 * DC / 4, -DC - 14 * DC / 4));
+	Mixer::StopSound(dcSound);
+	TEST_CHECK(BlockIs(0, 0));
+	const AudioMixerStats stolen = Since(stealStart);
+	TEST_CHECK(stolen.stolen == 2 && stolen.dropped == 0 && stolen.played == 2 * VOICES + 2);
+
+	// More commands than the queue holds between two callbacks: the rest are counted as dropped, not lost silently
+	const AudioMixerStats queueStart = Mixer::GetStats();
+	for (int n = 0; n < QUEUE_DEPTH + 36; n++)
+	{
+		Mixer::PlaySound(dcSound, false, 0.0f);
+	}
+	TEST_CHECK(BlockIs(0, 0));
+	const AudioMixerStats queued = Since(queueStart);
+	TEST_CHECK(queued.played == QUEUE_DEPTH && queued.dropped == 36 && queued.stolen == QUEUE_DEPTH - VOICES);
+	Mixer::StopSound(dcSound);
+	TEST_CHECK(BlockIs(0, 0));
+
+	Mixer::Stop();
+	TEST_CHECK(!Mixer::IsActive() && Mixer::FindSound("dc") == INVALID_SOUND);
+	fs::remove_all(directory);
+	return Test::Finish("AudioMixerTest");
+}
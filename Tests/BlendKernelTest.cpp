@@ -0,0 +1,158 @@
+// Includes
+#include <random>
+#include <vector>
+
+#include "Play.h"
+#include "TestCommon.h"
+
+// BlendKernelTest.cpp
+// Checks that the row kernels at every SIMD level this CPU supports give exactly the pixels, and end exactly where,
+// the per-pixel blend policies would. Rows are random pre-multiplied pixels with transparent runs in the skip
+// encoding, blended from random start points (which can land in the middle of a run) over random destinations.
+
+#pragma region Helpers
+namespace {
+
+	using namespace Play::Render;
+
+	std::mt19937 rng(1);
+
+	// Straight alpha pixels, a quarter of them opaque, a quarter transparent and the rest in between, with transparent runs
+	std::vector<uint32_t> MakeCanvasRow(int width)
+	{
+		std::vector<uint32_t> row(width);
+		for (int x = 0; x < width; x++)
+		{
+			const uint32_t kind = rng() % 4;
+			const uint32_t alpha = kind == 0 ? 0 : kind == 1 ? 255 : rng() & 0xFF;
+			row[x] = (alpha << 24) | (rng() & 0xFFFFFF);
+		}
+		for (int x = 0; x < width; x++)
+		{
+			if (rng() % 5 == 0)
+			{
+				for (int run = rng() % 20; run > 0 && x < width; run--, x++)
+				{
+					row[x] &= 0x00FFFFFF;
+				}
+			}
+		}
+		return row;
+	}
+
+	// The same rules as Graphics::PreMultiplyAlpha: inverted alpha, and a transparent pixel holds how many follow it
+	std::vector<uint32_t> PreMultiplyRow(const std::vector<uint32_t>& canvas)
+	{
+		const int width = static_cast<int>(canvas.size());
+		std::vector<uint32_t> row(width);
+		for (int x = 0; x < width; x++)
+		{
+			const uint32_t src = canvas[x];
+			const uint32_t alpha = src >> 24;
+			const uint32_t red = (alpha * ((src >> 16) & 0xFF)) >> 8;
+			const uint32_t green = (alpha * ((src >> 8) & 0xFF)) >> 8;
+			const uint32_t blue = (alpha * (src & 0xFF)) >> 8;
+			row[x] = ((0xFF - alpha) << 24) | (red << 16) | (green << 8) | blue;
+			if (alpha == 0)
+			{
+				uint32_t repeats = 0;
+				while (x + 1 + static_cast<int>(repeats) < width && (canvas[x + 1 + repeats] >> 24) == 0)
+				{
+					repeats++;
+				}
+				row[x] = 0xFF000000 | repeats;
+			}
+		}
+		return row;
+	}
+
+	template <typename TBlend>
+	void ReferenceRow(uint32_t* srcPixels, uint32_t* destPixels, const uint32_t* destRowEnd, Play::BlendColour globalMultiply, bool fast)
+	{
+		while (destPixels < destRowEnd)
+		{
+			if (fast)
+			{
+				TBlend::BlendFastSkip(srcPixels, destPixels, destRowEnd);
+			}
+			else
+			{
+				TBlend::BlendSkip(srcPixels, destPixels, globalMultiply, destRowEnd);
+			}
+		}
+	}
+
+	enum Kernel { ALPHA_FAST, ALPHA, ADDITIVE, MULTIPLY, KERNEL_COUNT };
+	const char* KERNEL_NAMES[KERNEL_COUNT] = { "alphaFast", "alpha", "additive", "multiply" };
+
+}
+#pragma endregion
+
+int main()
+{
+	const SimdLevel detected = DetectSimdLevel();
+	std::printf("SIMD level %d detected\n", static_cast<int>(detected));
+
+	int checks = 0;
+	for (int iteration = 0; iteration < 20000; iteration++)
+	{
+		const int width = 1 + rng() % 70;
+		const int start = rng() % std::min(width, 8);
+		const int length = 1 + rng() % (width - start);
+
+		const std::vector<uint32_t> canvas = MakeCanvasRow(width);
+		const std::vector<uint32_t> preMultiplied = PreMultiplyRow(canvas);
+		std::vector<uint32_t> dest(width);
+		for (uint32_t& pixel : dest)
+		{
+			pixel = rng();
+		}
+
+		// Alpha within [0, 1] as the kernels require; the colour channels may boost
+		Play::BlendColour globalMultiply = { (rng() % 101) / 100.0f, (rng() % 130) / 100.0f, (rng() % 101) / 100.0f, (rng() % 101) / 100.0f };
+		if (rng() % 4 == 0)
+		{
+			globalMultiply = { 1.0f, 1.0f, 1.0f, 1.0f };
+		}
+
+		for (int kernel = 0; kernel < KERNEL_COUNT; kernel++)
+		{
+			// Multiply blends from the unmodified canvas, the others from the pre-multiplied buffer
+			const std::vector<uint32_t>& src = kernel == MULTIPLY ? canvas : preMultiplied;
+			uint32_t* srcStart = const_cast<uint32_t*>(src.data()) + start;
+
+			std::vector<uint32_t> expected = dest;
+			uint32_t* expectedStart = expected.data() + start;
+			switch (kernel)
+			{
+			case ALPHA_FAST: ReferenceRow<AlphaBlendPolicy>(srcStart, expectedStart, expectedStart + length, globalMultiply, true); break;
+			case ALPHA: ReferenceRow<AlphaBlendPolicy>(srcStart, expectedStart, expectedStart + length, globalMultiply, false); break;
+			case ADDITIVE: ReferenceRow<AdditiveBlendPolicy>(srcStart, expectedStart, expectedStart + length, globalMultiply, false); break;
+			default: ReferenceRow<MultiplyBlendPolicy>(srcStart, expectedStart, expectedStart + length, globalMultiply, false); break;
+			}
+
+			for (int level = 0; level <= static_cast<int>(detected); level++)
+			{
+				SetSimdLevel(static_cast<SimdLevel>(level));
+				const BlendRowFunc functions[KERNEL_COUNT] = { blendRowKernels->alphaFast, blendRowKernels->alpha, blendRowKernels->additive, blendRowKernels->multiply };
+
+				std::vector<uint32_t> actual = dest;
+				uint32_t* srcPixels = srcStart;
+				uint32_t* destPixels = actual.data() + start;
+				const uint32_t* destRowEnd = destPixels + length;
+				functions[kernel](srcPixels, destPixels, destRowEnd, globalMultiply);
+				checks++;
+
+				if (actual != expected || destPixels != destRowEnd || srcPixels != srcStart + length)
+				{
+					std::printf("%s at level %d: width %d start %d length %d\n", KERNEL_NAMES[kernel], level, width, start, length);
+					TEST_CHECK(actual == expected && destPixels == destRowEnd && srcPixels == srcStart + length);
+				}
+			}
+		}
+	}
+	SetSimdLevel(detected);
+	std::printf("%d rows compared\n", checks);
+
+	return Test::Finish("BlendKernelTest");
+}
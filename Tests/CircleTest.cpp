@@ -0,0 +1,164 @@
+// Includes
+#include <filesystem>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "Play.h"
+#include "TestCommon.h"
+
+// CircleTest.cpp
+// Checks Graphics::DrawCircle, which draws cached horizontal spans, against the octant plotting it replaced.
+// The reference collects the points the old midpoint loop plotted (eight per step, with its x + 0.5 truncation),
+// drops the duplicates so each pixel is blended once, fills each row between its extremes for filled circles, and
+// blends them one at a time with DrawPixel. Random radii, centres (many partly off the buffer), colours and blend
+// modes are drawn over random backgrounds, outlined and filled.
+
+#pragma region Helpers
+namespace {
+
+	using namespace Play;
+
+	constexpr int WIDTH = 97;
+	constexpr int HEIGHT = 83;
+
+	// The pixels the old DrawCircle plotted, in display coordinates (y up)
+	std::set<std::pair<int, int>> OctantPoints(int x, int y, int radius, bool fill)
+	{
+		// The old loop scattered a few pixels for radius 0; now it is just the centre
+		std::set<std::pair<int, int>> points;
+		if (radius == 0)
+		{
+			points.insert({ x, y });
+			return points;
+		}
+
+		auto plot = [&](int offsetX, int offsetY)
+		{
+			points.insert({ { x + offsetX, y + offsetY }, { x - offsetX, y + offsetY }, { x + offsetX, y - offsetY }, { x - offsetX, y - offsetY },
+				{ x - offsetY, y + offsetX }, { x + offsetY, y - offsetX }, { x - offsetY, y - offsetX }, { x + offsetY, y + offsetX } });
+		};
+
+		int dx = 0, dy = radius, d = 3 - 2 * radius;
+		plot(dx, dy);
+		while (dy >= dx)
+		{
+			dx++;
+			if (d > 0)
+			{
+				dy--;
+				d = d + 4 * (dx - dy) + 10;
+			}
+			else
+			{
+				d = d + 4 * dx + 6;
+			}
+			plot(dx, dy);
+		}
+
+		if (fill)
+		{
+			std::map<int, std::pair<int, int>> rows;
+			for (const auto& [px, py] : points)
+			{
+				auto row = rows.try_emplace(py, px, px).first;
+				row->second.first = std::min(row->second.first, px);
+				row->second.second = std::max(row->second.second, px);
+			}
+			points.clear();
+			for (const auto& [py, extent] : rows)
+			{
+				for (int px = extent.first; px <= extent.second; px++)
+				{
+					points.insert({ px, py });
+				}
+			}
+		}
+		return points;
+	}
+
+}
+#pragma endregion
+
+int main()
+{
+	// No sprites are needed, just the display buffer
+	const std::filesystem::path noSprites = std::filesystem::temp_directory_path() / "PlayCircleTest";
+	std::filesystem::create_directories(noSprites);
+	Graphics::CreateManager(WIDTH, HEIGHT, (noSprites.string() + "/").c_str());
+	Window::CreateManager(Graphics::GetDrawingBuffer(), 1);
+	PixelData* display = Graphics::GetDrawingBuffer();
+
+	std::vector<Pixel> reference(WIDTH * HEIGHT);
+	PixelData referenceTarget{ WIDTH, HEIGHT, reference.data() };
+
+	std::mt19937 rng(3);
+	int cases = 0;
+	for (int trial = 0; trial < 6000; trial++)
+	{
+		// Every small radius (including 0) first, then random ones
+		const int radius = trial < 200 ? trial % 70 : static_cast<int>(rng() % 60);
+		const float centreX = static_cast<float>(rng() % ((WIDTH + 40) * 4)) / 4.0f - 20.0f;
+		const float centreY = static_cast<float>(rng() % ((HEIGHT + 40) * 4)) / 4.0f - 20.0f;
+		const bool fill = trial & 1;
+		const Graphics::BlendMode mode = static_cast<Graphics::BlendMode>((trial >> 1) % 3);
+		Pixel pix(static_cast<uint32_t>(rng()));
+		if (trial % 5 == 0)
+		{
+			pix.a = 0xFF;
+		}
+		if (trial % 17 == 0)
+		{
+			pix.a = 0x00;
+		}
+
+		for (int i = 0; i < WIDTH * HEIGHT; i++)
+		{
+			display->pPixels[i].bits = reference[i].bits = rng() | 0xFF000000;
+		}
+
+		Graphics::SetBlendMode(mode);
+		Graphics::DrawCircle({ centreX, centreY }, radius, pix, fill);
+
+		Render::SetRenderTarget(&referenceTarget);
+		// The centre was truncated the way DrawPixel truncates, towards zero
+		const int oldX = static_cast<int>(centreX + 0.5f), oldY = static_cast<int>(centreY + 0.5f);
+		for (const auto& [x, y] : OctantPoints(oldX, oldY, radius, fill))
+		{
+			// DrawPixel flipped y; points off the buffer are left out
+			const int screenX = x, screenY = HEIGHT - y;
+			if (mode == Graphics::BLEND_NORMAL)
+			{
+				Render::DrawPixelPreMult<Render::AlphaBlendPolicy>(screenX, screenY, pix);
+			}
+			else if (mode == Graphics::BLEND_ADD)
+			{
+				Render::DrawPixelPreMult<Render::AdditiveBlendPolicy>(screenX, screenY, pix);
+			}
+			else
+			{
+				Render::DrawPixel<Render::MultiplyBlendPolicy>(screenX, screenY, pix);
+			}
+		}
+		Render::SetRenderTarget(display);
+		cases++;
+
+		int different = 0;
+		for (int i = 0; i < WIDTH * HEIGHT; i++)
+		{
+			different += display->pPixels[i].bits != reference[i].bits;
+		}
+		if (different > 0)
+		{
+			std::printf("radius %d fill %d mode %d centre %.2f,%.2f alpha %d: %d pixels differ\n", radius, fill, mode, centreX, centreY, pix.a, different);
+			TEST_CHECK(different == 0);
+		}
+	}
+	std::printf("%d circles compared\n", cases);
+
+	Window::DestroyManager();
+	Graphics::DestroyManager();
+	std::filesystem::remove_all(noSprites);
+	return Test::Finish("CircleTest");
+}
@@ -0,0 +1,221 @@
+// Includes
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Play.h"
+#include "TestCommon.h"
+
+// DeferredTest.cpp
+// Checks that drawing deferred (recorded, then rasterized in tiles across threads) gives exactly the pixels of
+// drawing immediately. Each seed picks a display size, random sprites and a few hundred random drawing calls:
+// sprites plain, with a global multiply and transformed (some far larger than the display), pixels, lines, rects,
+// circles, debug text, blend mode changes, clears and the background. They are drawn immediately, then again
+// deferred with 1-4 threads and tiles of 8 pixels to 64, flushing halfway through.
+//
+// Usage: DeferredTest [seed count]
+
+#pragma region Helpers
+namespace {
+
+	// Play has wrappers with the same names as some of Graphics' functions
+	using namespace Play::Graphics;
+	using Play::BlendColour;
+	using Play::Matrix2D;
+	using Play::Pixel;
+	using Play::PixelData;
+
+	constexpr int SPRITE_COUNT = 4;
+
+	struct Op
+	{
+		int kind;
+		float f[8];
+		unsigned i[4];
+		std::string text;
+	};
+
+	// Sprites of random sizes and frame counts, with transparent, opaque and translucent pixels
+	void AddSprites(std::mt19937& rng)
+	{
+		for (int n = 0; n < SPRITE_COUNT; n++)
+		{
+			const int frameWidth = 5 + rng() % 40, frameHeight = 5 + rng() % 40, frames = 1 + rng() % 3;
+			PixelData pixels{ frameWidth * frames, frameHeight, new Pixel[frameWidth * frames * frameHeight] };
+			for (int k = 0; k < pixels.width * pixels.height; k++)
+			{
+				const uint32_t alpha = (rng() % 3 == 0) ? 0 : (rng() % 2 ? 255 : rng() % 256);
+				pixels.pPixels[k] = (alpha << 24) | (rng() & 0xFFFFFF);
+			}
+			const int id = AddSprite("SPRITE" + std::to_string(n), pixels, frames, 1);
+			SetSpriteOrigin(id, { static_cast<float>(rng() % frameWidth), static_cast<float>(rng() % frameHeight) }, false);
+		}
+	}
+
+	std::vector<Op> MakeOps(std::mt19937& rng, int count, int width, int height)
+	{
+		std::uniform_real_distribution<float> randomX(-60.0f, width + 60.0f), randomY(-60.0f, height + 60.0f), unit(0.0f, 1.0f);
+		std::vector<Op> ops;
+		for (int n = 0; n < count; n++)
+		{
+			Op op{};
+			op.kind = rng() % 14;
+			for (float& f : op.f)
+			{
+				f = unit(rng);
+			}
+			op.f[0] = randomX(rng);
+			op.f[1] = randomY(rng);
+			op.f[2] = randomX(rng);
+			op.f[3] = randomY(rng);
+			for (unsigned& i : op.i)
+			{
+				i = rng();
+			}
+			if (op.kind == 10)
+			{
+				for (int length = rng() % 12; length > 0; length--)
+				{
+					op.text += static_cast<char>(0x28 + rng() % 0x40);
+				}
+			}
+			// Clears and backgrounds are rare, or there would be little left to compare
+			if ((op.kind == 12 || op.kind == 13) && rng() % 8)
+			{
+				op.kind = rng() % 10;
+			}
+			ops.push_back(op);
+		}
+		return ops;
+	}
+
+	// Returns the sum of what the drawing calls return, which must not change either
+	long long Run(const std::vector<Op>& ops, size_t begin, size_t end)
+	{
+		long long returned = 0;
+		for (size_t n = begin; n < end; n++)
+		{
+			const Op& op = ops[n];
+			const Pixel pix(op.i[0] | ((op.i[1] & 1) ? 0xFF000000u : 0u));
+			const BlendColour globalMultiply = (op.i[2] & 1) ? BlendColour{ 1.0f, 1.0f, 1.0f, 1.0f } : BlendColour{ op.f[4], op.f[5], op.f[6], op.f[7] };
+			const int sprite = op.i[3] % SPRITE_COUNT;
+			switch (op.kind)
+			{
+			case 0:
+			case 1:
+				DrawTransparent(sprite, { op.f[0], op.f[1] }, op.i[2] % 7, globalMultiply);
+				break;
+			case 2:
+			{
+				const float scale = (op.i[1] % 16 == 0) ? 40.0f : 0.2f + 3.0f * op.f[5];
+				const Matrix2D transform = Play::MatrixScale(scale, scale * (0.5f + op.f[6])) * Play::MatrixRotation(op.f[4] * 7.0f) * Play::MatrixTranslation(op.f[0], op.f[1]);
+				DrawTransformed(sprite, transform, op.i[2] % 7, globalMultiply);
+				break;
+			}
+			case 3:
+				DrawPixel({ op.f[0] * 0.3f, op.f[1] }, pix);
+				DrawPixel({ op.f[2], op.f[3] }, pix);
+				break;
+			case 4:
+				DrawLine({ op.f[0], op.f[1] }, { op.f[2], op.f[3] }, pix);
+				break;
+			case 5:
+				DrawLine({ op.f[0], op.f[1] }, { op.f[0] + 30.0f * op.f[4] - 15.0f, op.f[1] + 30.0f * op.f[5] - 15.0f }, pix);
+				break;
+			case 6:
+				DrawRect({ op.f[0], op.f[1] }, { op.f[0] + 50.0f * op.f[4], op.f[1] + 50.0f * op.f[5] }, pix, op.i[3] & 1);
+				break;
+			case 7:
+				DrawCircle({ op.f[0], op.f[1] }, op.i[3] % 3 ? static_cast<int>(op.i[3] % 34) : static_cast<int>(op.i[3] % 120) - 1, pix, op.i[2] & 2);
+				break;
+			case 8:
+			case 9:
+				SetBlendMode(static_cast<BlendMode>(op.i[3] % 3));
+				break;
+			case 10:
+				returned += DrawDebugString({ op.f[0], op.f[1] }, op.text, pix, op.i[3] & 1);
+				break;
+			case 11:
+				DrawCircle({ op.f[0] * 0.2f - 5.0f, op.f[1] * 0.2f - 5.0f }, static_cast<int>(op.i[3] % 20), pix, op.i[2] & 2);
+				break;
+			case 12:
+				ClearBuffer(pix);
+				break;
+			default:
+				DrawBackground(0);
+				break;
+			}
+		}
+		return returned;
+	}
+
+}
+#pragma endregion
+
+int main(int argc, char** argv)
+{
+	const int seeds = argc > 1 ? std::atoi(argv[1]) : 200;
+	const char* BACKGROUND = "Data/Sprites/star.png";
+	if (!std::filesystem::exists(BACKGROUND))
+	{
+		std::printf("No background image at %s\n", BACKGROUND);
+		return Test::SKIP_CODE;
+	}
+
+	const std::filesystem::path noSprites = std::filesystem::temp_directory_path() / "PlayDeferredTest";
+	std::filesystem::create_directories(noSprites);
+
+	for (int seed = 0; seed < seeds; seed++)
+	{
+		std::mt19937 rng(seed);
+		const int width = 16 + rng() % 300, height = 16 + rng() % 250;
+		CreateManager(width, height, (noSprites.string() + "/").c_str());
+		Play::Window::CreateManager(GetDrawingBuffer(), 1);
+		AddSprites(rng);
+		LoadBackground(BACKGROUND);
+
+		const std::vector<Op> ops = MakeOps(rng, 60 + rng() % 300, width, height);
+		PixelData* display = GetDrawingBuffer();
+		std::vector<Pixel> initial(width * height);
+		for (Pixel& pixel : initial)
+		{
+			pixel = rng();
+		}
+
+		std::copy(initial.begin(), initial.end(), display->pPixels);
+		SetBlendMode(BLEND_NORMAL);
+		const long long immediateReturned = Run(ops, 0, ops.size());
+		const std::vector<Pixel> immediate(display->pPixels, display->pPixels + width * height);
+
+		const int threads = 1 + seed % 4;
+		const int tileSize = (seed / 4) % 3 == 0 ? 8 : ((seed / 4) % 3 == 1 ? 16 + seed % 37 : 64);
+		std::copy(initial.begin(), initial.end(), display->pPixels);
+		SetBlendMode(BLEND_NORMAL);
+		BeginDeferred(threads, tileSize);
+		long long deferredReturned = Run(ops, 0, ops.size() / 2);
+		FlushDeferred();
+		deferredReturned += Run(ops, ops.size() / 2, ops.size());
+		EndDeferred();
+
+		int different = 0;
+		for (int k = 0; k < width * height; k++)
+		{
+			different += display->pPixels[k].bits != immediate[k].bits;
+		}
+		if (different > 0 || deferredReturned != immediateReturned)
+		{
+			std::printf("seed %d: %dx%d, %d threads, %d pixel tiles: %d pixels differ, returned %lld rather than %lld\n",
+				seed, width, height, threads, tileSize, different, deferredReturned, immediateReturned);
+			TEST_CHECK(different == 0 && deferredReturned == immediateReturned);
+		}
+
+		Play::Window::DestroyManager();
+		DestroyManager();
+	}
+	std::printf("%d seeds compared\n", seeds);
+
+	std::filesystem::remove_all(noSprites);
+	return Test::Finish("DeferredTest");
+}
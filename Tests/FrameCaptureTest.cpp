@@ -0,0 +1,85 @@
+// Includes
+#include <cstdlib>
+#include <filesystem>
+
+#include "FrameCapture.h"
+#include "TestCommon.h"
+#include "Utils.h"
+
+// FrameCaptureTest.cpp
+// Checks that captured frames are written the right way up. Two frames are drawn with a marker in one corner
+// only (a red block top left, a smaller blue one bottom right) and captured through the present hook, then the
+// PNGs are loaded back and each corner's colour checked, so a frame flipped either way fails.
+// Needs a window, so it is skipped where there is no display.
+
+#pragma region Helpers
+namespace {
+
+	namespace fs = std::filesystem;
+
+	constexpr int WIDTH = 64;
+	constexpr int HEIGHT = 48;
+
+	bool SameColour(const Color& a, const Color& b)
+	{
+		return a.r == b.r && a.g == b.g && a.b == b.b;
+	}
+
+}
+#pragma endregion
+
+int main()
+{
+#if defined(__linux__)
+	if (!std::getenv("DISPLAY") && !std::getenv("WAYLAND_DISPLAY"))
+	{
+		std::printf("No display to open a window on\n");
+		return Test::SKIP_CODE;
+	}
+#endif
+
+	SetConfigFlags(FLAG_WINDOW_HIDDEN);
+	Play::CreateManager(WIDTH, HEIGHT, 1);
+	if (!IsWindowReady())
+	{
+		std::printf("No window\n");
+		return Test::SKIP_CODE;
+	}
+
+	const fs::path directory = fs::temp_directory_path() / "PacmanFrameCaptureTest";
+	fs::remove_all(directory);
+	FrameCaptureSettings settings;
+	settings.directory = directory.string();
+	TEST_CHECK(StartFrameCapture(settings));
+
+	for (int frame = 0; frame < 2; ++frame)
+	{
+		Play::ClearDrawingBuffer(Play::cBlack);
+		Play::DrawRect({ 0, 0 }, { 15, 11 }, Play::cRed);
+		Play::DrawRect({ WIDTH - 8, HEIGHT - 6 }, { WIDTH - 1, HEIGHT - 1 }, Play::cBlue);
+		Play::PresentDrawingBuffer();
+	}
+	StopFrameCapture();
+
+	const FrameCaptureStats stats = GetFrameCaptureStats();
+	TEST_CHECK(stats.written == 2 && stats.dropped == 0);
+
+	for (int frame = 0; frame < 2; ++frame)
+	{
+		const fs::path file = directory / (frame == 0 ? "frame_000000.png" : "frame_000001.png");
+		Image image = LoadImage(file.string().c_str());
+		TEST_CHECK(image.width == WIDTH && image.height == HEIGHT);
+		if (image.width == WIDTH && image.height == HEIGHT)
+		{
+			TEST_CHECK(SameColour(GetImageColor(image, 2, 2), Play::cRed));
+			TEST_CHECK(SameColour(GetImageColor(image, WIDTH - 2, HEIGHT - 2), Play::cBlue));
+			TEST_CHECK(SameColour(GetImageColor(image, 2, HEIGHT - 2), Play::cBlack));
+			TEST_CHECK(SameColour(GetImageColor(image, WIDTH - 2, 2), Play::cBlack));
+		}
+		UnloadImage(image);
+	}
+
+	Play::DestroyManager();
+	fs::remove_all(directory);
+	return Test::Finish("FrameCaptureTest");
+}
@@ -0,0 +1,202 @@
+// Includes
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "Play.h"
+#include "TestCommon.h"
+
+// GameObjectStoreTest.cpp
+// Checks the PlayManager's slot map of GameObjects against a plain list of every object in creation order, the way
+// the old std::map keyed by ever-increasing ids kept them. Random creates, destroys (one at a time, by type and all
+// at once) and type changes (through GetGameObject and UpdateGameObject) are applied to both, and after each the
+// id lists by type and overall must match the reference's, in order. Also checks that the ids of recently destroyed
+// objects no longer resolve, even after thousands of objects came and went, that references stay put while the store
+// grows, and that a slot whose generation wraps while its list isn't read is still listed once.
+
+#pragma region Helpers
+namespace {
+
+	struct Reference
+	{
+		int id;
+		int type;
+		bool alive;
+	};
+
+	constexpr int TYPE_COUNT = 6;
+	constexpr int GENERATIONS = 4096;   // GameObjectStore::GENERATION_MASK + 1
+	constexpr int MIN_FREE_SLOTS = 256; // GameObjectStore::MIN_FREE_SLOTS
+	const char* SPRITE = "dot";
+
+	std::vector<int> ReferenceIds(const std::vector<Reference>& objects, int type)
+	{
+		std::vector<int> ids;
+		for (const Reference& object : objects)
+		{
+			if (object.alive && (type < 0 || object.type == type))
+			{
+				ids.push_back(object.id);
+			}
+		}
+		return ids;
+	}
+
+	// Compares every list the store hands out with the reference's
+	bool ListsMatch(const std::vector<Reference>& objects)
+	{
+		bool match = Play::CollectAllGameObjectIDs() == ReferenceIds(objects, -1);
+		std::vector<int> ids;
+		for (int type = 0; type < TYPE_COUNT; type++)
+		{
+			const std::vector<int> expected = ReferenceIds(objects, type);
+			Play::CollectGameObjectIDsByType(type, ids);
+			match = match && ids == expected && Play::GetGameObjectIDsByType(type) == expected;
+		}
+		return match;
+	}
+
+}
+#pragma endregion
+
+int main()
+{
+	// One sprite to give the objects, and no others
+	const std::filesystem::path noSprites = std::filesystem::temp_directory_path() / "PlayGameObjectStoreTest";
+	std::filesystem::create_directories(noSprites);
+	Play::Graphics::CreateManager(64, 64, (noSprites.string() + "/").c_str());
+	Play::PixelData dot{ 1, 1, new Play::Pixel[1]{ 0xFFFFFFFF } };
+	Play::Graphics::AddSprite(SPRITE, dot);
+
+	// One object created and destroyed over and over: the first one's id still finds nothing. Done first, while
+	// the store is empty, so the free slots it cycles through are the ones it freed
+	const int firstId = Play::CreateGameObject(0, { 0.0f, 0.0f }, 1, SPRITE);
+	Play::DestroyGameObject(firstId);
+	for (int n = 0; n < 4096; n++)
+	{
+		const int id = Play::CreateGameObject(0, { 0.0f, 0.0f }, 1, SPRITE);
+		const bool found = Play::GetGameObject(firstId).type != -1;
+		Play::DestroyGameObject(id);
+		if (found)
+		{
+			std::printf("cycle %d: the first object's id finds an object again\n", n);
+			TEST_CHECK(!found);
+			break;
+		}
+	}
+
+	// The same until a slot's generation wraps, with nothing read in between: the survivor is listed once
+	const int keep = Play::CreateGameObject(2, { 0.0f, 0.0f }, 1, SPRITE);
+	int last = -1;
+	for (int n = 0; n < GENERATIONS * (MIN_FREE_SLOTS + 2) + 1; n++)
+	{
+		if (last >= 0)
+		{
+			Play::DestroyGameObject(last);
+		}
+		last = Play::CreateGameObject(3, { 0.0f, 0.0f }, 1, SPRITE);
+	}
+	TEST_CHECK((Play::CollectAllGameObjectIDs() == std::vector<int>{ keep, last }));
+	TEST_CHECK((Play::GetGameObjectIDsByType(3) == std::vector<int>{ last }));
+	Play::DestroyAllGameObjects();
+
+	std::mt19937 rng(5);
+	std::vector<Reference> objects;
+	std::vector<int> destroyed;
+	auto randomAlive = [&]() -> Reference*
+	{
+		std::vector<Reference*> alive;
+		for (Reference& object : objects)
+		{
+			if (object.alive)
+			{
+				alive.push_back(&object);
+			}
+		}
+		return alive.empty() ? nullptr : alive[rng() % alive.size()];
+	};
+
+	for (int step = 0; step < 20000; step++)
+	{
+		const int choice = rng() % 100;
+		const int type = rng() % TYPE_COUNT;
+		Reference* object = randomAlive();
+		if (choice < 45 || !object)
+		{
+			objects.push_back({ Play::CreateGameObject(type, { 0.0f, 0.0f }, 1, SPRITE), type, true });
+		}
+		else if (choice < 75)
+		{
+			Play::DestroyGameObject(object->id);
+			object->alive = false;
+			destroyed.push_back(object->id);
+		}
+		else if (choice < 85)
+		{
+			Play::GetGameObject(object->id).type = type;
+			object->type = type;
+		}
+		else if (choice < 95)
+		{
+			Play::GameObject& obj = Play::GetGameObject(object->id);
+			obj.type = type;
+			Play::UpdateGameObject(obj, false, 0, true);
+			object->type = type;
+		}
+		else if (choice < 99)
+		{
+			Play::DestroyGameObjectsByType(type);
+			for (Reference& other : objects)
+			{
+				if (other.alive && other.type == type)
+				{
+					other.alive = false;
+					destroyed.push_back(other.id);
+				}
+			}
+		}
+		else
+		{
+			Play::DestroyAllGameObjects();
+			for (Reference& other : objects)
+			{
+				if (other.alive)
+				{
+					other.alive = false;
+					destroyed.push_back(other.id);
+				}
+			}
+		}
+
+		// Reading every list each step would hide lists that go stale for a while
+		if (step % 7 == 0 && !ListsMatch(objects))
+		{
+			std::printf("step %d: the id lists differ from the reference\n", step);
+			TEST_CHECK(ListsMatch(objects));
+			break;
+		}
+
+		// A slot can't have been reused 4096 times within the last 100 destroys, so these ids must all be dead
+		for (size_t n = destroyed.size() > 100 ? destroyed.size() - 100 : 0; n < destroyed.size(); n++)
+		{
+			TEST_CHECK(Play::GetGameObject(destroyed[n]).type == -1);
+		}
+	}
+	TEST_CHECK(ListsMatch(objects));
+
+	// References stay valid while the store grows
+	Play::DestroyAllGameObjects();
+	const int firstLive = Play::CreateGameObject(0, { 0.0f, 0.0f }, 1, SPRITE);
+	Play::GameObject* first = &Play::GetGameObject(firstLive);
+	for (int n = 0; n < 5000; n++)
+	{
+		Play::CreateGameObject(1, { 0.0f, 0.0f }, 1, SPRITE);
+	}
+	TEST_CHECK(&Play::GetGameObject(firstLive) == first);
+	TEST_CHECK(Play::GetGameObjectIDsByType(1).size() == 5000);
+
+	Play::DestroyAllGameObjects();
+	Play::Graphics::DestroyManager();
+	std::filesystem::remove_all(noSprites);
+	return Test::Finish("GameObjectStoreTest");
+}
@@ -0,0 +1,408 @@
+// Includes
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "Play.h"
+#include "TestCommon.h"
+
+// PngDecodeTest.cpp
+// Checks Play's portable png decoder against images this test encodes itself.
+// - Every colour type and bit depth the format allows, plain and Adam7 interlaced, with random filters,
+//   zlib levels 0-9, tRNS chunks and image data split over several IDAT chunks
+// - Truncated files must be rejected; bit-flipped and overwritten files (of the generated images and of
+//   Data/Sprites) must decode or be rejected without reading out of bounds, which a sanitizer build checks
+//
+// Usage: PngDecodeTest [sprite directory]
+
+#pragma region Encoder
+namespace {
+
+	struct Case
+	{
+		int width = 1;
+		int height = 1;
+		int colourType = 6;
+		int depth = 8;
+		bool interlaced = false;
+		int level = 6;
+		bool transparency = false;
+		size_t split = 0; // bytes per IDAT chunk, 0 for a single chunk
+	};
+
+	struct Encoded
+	{
+		std::vector<uint8_t> png;
+		std::vector<uint32_t> expected; // straight (not premultiplied) ARGB, as the decoder gives
+	};
+
+	int Channels(int colourType)
+	{
+		switch (colourType)
+		{
+		case 2: return 3;
+		case 4: return 2;
+		case 6: return 4;
+		default: return 1;
+		}
+	}
+
+	void PutBigEndian32(std::vector<uint8_t>& out, uint32_t value)
+	{
+		for (int shift = 24; shift >= 0; shift -= 8)
+		{
+			out.push_back(static_cast<uint8_t>(value >> shift));
+		}
+	}
+
+	void PutChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data)
+	{
+		PutBigEndian32(out, static_cast<uint32_t>(data.size()));
+		const size_t start = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data.begin(), data.end());
+		PutBigEndian32(out, static_cast<uint32_t>(crc32(0, out.data() + start, static_cast<uInt>(out.size() - start))));
+	}
+
+	// Packs samples most significant bits first, as png rows are
+	std::vector<uint8_t> PackRow(const std::vector<int>& samples, int depth)
+	{
+		std::vector<uint8_t> row;
+		if (depth == 16)
+		{
+			for (int s : samples)
+			{
+				row.push_back(static_cast<uint8_t>(s >> 8));
+				row.push_back(static_cast<uint8_t>(s));
+			}
+			return row;
+		}
+
+		int bits = 0;
+		int count = 0;
+		for (int s : samples)
+		{
+			bits = (bits << depth) | s;
+			count += depth;
+			if (count == 8)
+			{
+				row.push_back(static_cast<uint8_t>(bits));
+				bits = 0;
+				count = 0;
+			}
+		}
+		if (count > 0)
+		{
+			row.push_back(static_cast<uint8_t>(bits << (8 - count)));
+		}
+		return row;
+	}
+
+	int Paeth(int a, int b, int c)
+	{
+		const int p = a + b - c;
+		const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+		return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+	}
+
+	void FilterRow(int type, const std::vector<uint8_t>& row, const std::vector<uint8_t>& prior, size_t bpp, std::vector<uint8_t>& out)
+	{
+		out.push_back(static_cast<uint8_t>(type));
+		for (size_t i = 0; i < row.size(); i++)
+		{
+			const int a = i >= bpp ? row[i - bpp] : 0;
+			const int b = prior[i];
+			const int c = i >= bpp ? prior[i - bpp] : 0;
+			const int predictions[5] = { 0, a, b, (a + b) / 2, Paeth(a, b, c) };
+			out.push_back(static_cast<uint8_t>(row[i] - predictions[type]));
+		}
+	}
+
+	// Scales a sample to 8 bits the way the decoder does: low depths replicate, 16 bits keeps the high byte
+	uint32_t To8Bits(int sample, int depth)
+	{
+		if (depth == 16)
+		{
+			return static_cast<uint32_t>(sample >> 8);
+		}
+		return static_cast<uint32_t>(sample * (255 / ((1 << depth) - 1)));
+	}
+
+	Encoded Encode(const Case& c, std::mt19937& rng)
+	{
+		const int channels = Channels(c.colourType);
+		const int paletteSize = c.colourType == 3 ? std::min(256, 1 << c.depth) : 0;
+		const int maxSample = c.colourType == 3 ? paletteSize - 1 : (1 << c.depth) - 1;
+		auto random = [&rng](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+		// Random samples, half of them repeating their left neighbour so there are runs for deflate to match
+		std::vector<int> samples(static_cast<size_t>(c.width) * c.height * channels);
+		for (size_t i = 0; i < samples.size(); i++)
+		{
+			const bool repeat = i >= static_cast<size_t>(channels) && (i / channels) % c.width != 0 && random(0, 1) == 0;
+			samples[i] = repeat ? samples[i - channels] : random(0, maxSample);
+		}
+		auto sample = [&](int x, int y, int channel) { return samples[(static_cast<size_t>(y) * c.width + x) * channels + channel]; };
+
+		// Filtered rows, pass by pass
+		static const int ADAM7[7][4] = { { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 }, { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 } };
+		const size_t bpp = std::max(1, channels * c.depth / 8);
+		std::vector<uint8_t> raw;
+		for (int pass = 0; pass < (c.interlaced ? 7 : 1); pass++)
+		{
+			const int x0 = c.interlaced ? ADAM7[pass][0] : 0, y0 = c.interlaced ? ADAM7[pass][1] : 0;
+			const int dx = c.interlaced ? ADAM7[pass][2] : 1, dy = c.interlaced ? ADAM7[pass][3] : 1;
+			const int passWidth = c.width > x0 ? (c.width - x0 + dx - 1) / dx : 0;
+			const int passHeight = c.height > y0 ? (c.height - y0 + dy - 1) / dy : 0;
+			if (passWidth == 0 || passHeight == 0)
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> prior((static_cast<size_t>(passWidth) * channels * c.depth + 7) / 8, 0);
+			for (int j = 0; j < passHeight; j++)
+			{
+				std::vector<int> rowSamples;
+				for (int i = 0; i < passWidth; i++)
+				{
+					for (int channel = 0; channel < channels; channel++)
+					{
+						rowSamples.push_back(sample(x0 + i * dx, y0 + j * dy, channel));
+					}
+				}
+				std::vector<uint8_t> row = PackRow(rowSamples, c.depth);
+				FilterRow(random(0, 4), row, prior, bpp, raw);
+				prior = row;
+			}
+		}
+
+		std::vector<uint8_t> compressed(compressBound(static_cast<uLong>(raw.size())));
+		uLongf compressedSize = static_cast<uLongf>(compressed.size());
+		compress2(compressed.data(), &compressedSize, raw.data(), static_cast<uLong>(raw.size()), c.level);
+		compressed.resize(compressedSize);
+
+		Encoded encoded;
+		std::vector<uint8_t>& png = encoded.png;
+		const uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		png.assign(SIGNATURE, SIGNATURE + 8);
+
+		std::vector<uint8_t> header;
+		PutBigEndian32(header, static_cast<uint32_t>(c.width));
+		PutBigEndian32(header, static_cast<uint32_t>(c.height));
+		header.insert(header.end(), { static_cast<uint8_t>(c.depth), static_cast<uint8_t>(c.colourType), 0, 0, static_cast<uint8_t>(c.interlaced) });
+		PutChunk(png, "IHDR", header);
+
+		// A palette with alpha for some of its entries, or a colour key picked from the image
+		std::vector<uint32_t> palette(paletteSize);
+		std::vector<int> key;
+		if (c.colourType == 3)
+		{
+			std::vector<uint8_t> plte;
+			for (uint32_t& colour : palette)
+			{
+				const uint32_t r = random(0, 255), g = random(0, 255), b = random(0, 255);
+				plte.insert(plte.end(), { static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b) });
+				colour = 0xFF000000 | (r << 16) | (g << 8) | b;
+			}
+			PutChunk(png, "PLTE", plte);
+
+			if (c.transparency)
+			{
+				std::vector<uint8_t> trns(random(1, paletteSize));
+				for (size_t i = 0; i < trns.size(); i++)
+				{
+					trns[i] = static_cast<uint8_t>(random(0, 255));
+					palette[i] = (palette[i] & 0x00FFFFFF) | (static_cast<uint32_t>(trns[i]) << 24);
+				}
+				PutChunk(png, "tRNS", trns);
+			}
+		}
+		else if (c.transparency && (c.colourType == 0 || c.colourType == 2))
+		{
+			const int x = random(0, c.width - 1), y = random(0, c.height - 1);
+			std::vector<uint8_t> trns;
+			for (int channel = 0; channel < channels; channel++)
+			{
+				key.push_back(sample(x, y, channel));
+				trns.push_back(static_cast<uint8_t>(key.back() >> 8));
+				trns.push_back(static_cast<uint8_t>(key.back()));
+			}
+			PutChunk(png, "tRNS", trns);
+		}
+
+		const size_t split = c.split > 0 ? c.split : std::max<size_t>(compressed.size(), 1);
+		for (size_t offset = 0; offset < compressed.size() || offset == 0; offset += split)
+		{
+			const size_t end = std::min(compressed.size(), offset + split);
+			PutChunk(png, "IDAT", std::vector<uint8_t>(compressed.begin() + offset, compressed.begin() + end));
+		}
+		PutChunk(png, "IEND", {});
+
+		for (int y = 0; y < c.height; y++)
+		{
+			for (int x = 0; x < c.width; x++)
+			{
+				uint32_t a = 255, r, g, b;
+				switch (c.colourType)
+				{
+				case 3:
+					encoded.expected.push_back(palette[sample(x, y, 0)]);
+					continue;
+				case 0:
+				case 4:
+					r = g = b = To8Bits(sample(x, y, 0), c.depth);
+					if (c.colourType == 4)
+					{
+						a = To8Bits(sample(x, y, 1), c.depth);
+					}
+					else if (!key.empty() && sample(x, y, 0) == key[0])
+					{
+						a = 0;
+					}
+					break;
+				default:
+					r = To8Bits(sample(x, y, 0), c.depth);
+					g = To8Bits(sample(x, y, 1), c.depth);
+					b = To8Bits(sample(x, y, 2), c.depth);
+					if (c.colourType == 6)
+					{
+						a = To8Bits(sample(x, y, 3), c.depth);
+					}
+					else if (!key.empty() && sample(x, y, 0) == key[0] && sample(x, y, 1) == key[1] && sample(x, y, 2) == key[2])
+					{
+						a = 0;
+					}
+					break;
+				}
+				encoded.expected.push_back((a << 24) | (r << 16) | (g << 8) | b);
+			}
+		}
+		return encoded;
+	}
+
+	// Decodes `png`, freeing the pixels; returns the decoder's result
+	int Decode(const std::vector<uint8_t>& png, std::vector<uint32_t>* pixels = nullptr, int* width = nullptr, int* height = nullptr)
+	{
+		Play::PixelData image;
+		const int result = Play::DecodePNGImage(png.data(), png.size(), image);
+		if (result == Play::PNG_OK)
+		{
+			if (pixels)
+			{
+				pixels->assign(reinterpret_cast<const uint32_t*>(image.pPixels), reinterpret_cast<const uint32_t*>(image.pPixels) + static_cast<size_t>(image.width) * image.height);
+				*width = image.width;
+				*height = image.height;
+			}
+			delete[] image.pPixels;
+		}
+		return result;
+	}
+
+}
+#pragma endregion
+
+int main(int argc, char** argv)
+{
+	std::mt19937 rng(7);
+	auto random = [&rng](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+	// Every legal colour type and depth combination
+	static const int FORMATS[][2] = {
+		{ 0, 1 }, { 0, 2 }, { 0, 4 }, { 0, 8 }, { 0, 16 },
+		{ 2, 8 }, { 2, 16 },
+		{ 3, 1 }, { 3, 2 }, { 3, 4 }, { 3, 8 },
+		{ 4, 8 }, { 4, 16 },
+		{ 6, 8 }, { 6, 16 },
+	};
+	static const int LEVELS[] = { 0, 1, 6, 9 };
+	static const size_t SPLITS[] = { 0, 7, 100 };
+
+	std::vector<std::vector<uint8_t>> generated;
+	int cases = 0;
+	for (const auto& format : FORMATS)
+	{
+		for (int trial = 0; trial < 12; trial++)
+		{
+			Case c;
+			c.colourType = format[0];
+			c.depth = format[1];
+			// Small sizes cover the empty Adam7 passes, larger ones rows longer than a deflate window of matches
+			c.width = trial < 4 ? random(1, 9) : random(1, 80);
+			c.height = trial < 4 ? random(1, 9) : random(1, 80);
+			c.interlaced = trial % 2 == 1;
+			c.level = LEVELS[trial % 4];
+			c.transparency = trial % 3 == 0;
+			c.split = SPLITS[trial % 3];
+
+			const Encoded encoded = Encode(c, rng);
+			std::vector<uint32_t> pixels;
+			int width = 0, height = 0;
+			const int result = Decode(encoded.png, &pixels, &width, &height);
+			cases++;
+			if (result != Play::PNG_OK || width != c.width || height != c.height || pixels != encoded.expected)
+			{
+				std::printf("colour type %d depth %d %dx%d interlaced %d level %d tRNS %d split %zu: result %d\n",
+					c.colourType, c.depth, c.width, c.height, c.interlaced, c.level, c.transparency, c.split, result);
+				TEST_CHECK(result == Play::PNG_OK && width == c.width && height == c.height && pixels == encoded.expected);
+			}
+			generated.push_back(encoded.png);
+		}
+	}
+	std::printf("%d generated images decoded\n", cases);
+
+	// Corrupt copies of the generated images and of the game's sprites
+	std::vector<std::vector<uint8_t>> sources(generated.begin(), generated.end());
+	const std::string spriteDirectory = argc > 1 ? argv[1] : "Data/Sprites";
+	if (std::filesystem::exists(spriteDirectory))
+	{
+		for (const auto& entry : std::filesystem::directory_iterator(spriteDirectory))
+		{
+			std::vector<uint8_t> bytes;
+			if (entry.path().extension() == ".png" && Play::ReadFileBytes(entry.path().string(), bytes))
+			{
+				TEST_CHECK(Decode(bytes) == Play::PNG_OK);
+				sources.push_back(std::move(bytes));
+			}
+		}
+	}
+
+	const int FUZZ_RUNS = 3000;
+	for (int run = 0; run < FUZZ_RUNS; run++)
+	{
+		std::vector<uint8_t> png = sources[random(0, static_cast<int>(sources.size()) - 1)];
+		switch (run % 3)
+		{
+		case 0:
+			// Every chunk is needed up to IEND, so a file cut short anywhere is not a png
+			png.resize(random(0, static_cast<int>(png.size()) - 1));
+			TEST_CHECK(Decode(png) != Play::PNG_OK);
+			continue;
+		case 1:
+			for (int flips = random(1, 20); flips > 0; flips--)
+			{
+				png[random(0, static_cast<int>(png.size()) - 1)] ^= static_cast<uint8_t>(1 << random(0, 7));
+			}
+			break;
+		default:
+		{
+			// Overwrite a run after the signature and IHDR
+			const int start = random(33, static_cast<int>(png.size()) - 1);
+			for (int i = start; i < std::min(static_cast<int>(png.size()), start + random(1, 64)); i++)
+			{
+				png[i] = static_cast<uint8_t>(random(0, 255));
+			}
+			break;
+		}
+		}
+
+		// The decoder doesn't check CRCs, so these may still decode; they just mustn't crash
+		const int result = Decode(png);
+		TEST_CHECK(result == Play::PNG_OK || result == Play::PNG_ERROR_FORMAT || result == Play::PNG_ERROR_CORRUPT);
+	}
+	std::printf("%d corrupted files from %zu sources decoded or rejected\n", FUZZ_RUNS, sources.size());
+
+	return Test::Finish("PngDecodeTest");
+}
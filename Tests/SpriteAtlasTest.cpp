@@ -0,0 +1,246 @@
+// Includes
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "RaylibPlayCompat.h"
+#include "TestCommon.h"
+
+// SpriteAtlasTest.cpp
+// Checks the raylib build's sprite atlas against the pngs it is packed from. Data/Sprites is loaded with the
+// default page size and with pages small enough to need several. Every sprite must have the frame count and size
+// its file name gives, and every frame must be a rectangle of the right size, inside its page, overlapping no other
+// frame and holding that frame's pixels. Frames are then drawn through a software target, clipped at each edge and
+// with frame numbers that wrap, and compared with the source pixels blended by hand. No window is needed.
+
+#pragma region Helpers
+namespace {
+
+	namespace fs = std::filesystem;
+
+	const char* SPRITES = "Data/Sprites";
+	constexpr int SMALL_PAGE = 512;
+	constexpr int TARGET_W = 200, TARGET_H = 150;
+
+	struct Source
+	{
+		std::string name; // uppercase, as the atlas stores it
+		Image image{};
+		int across = 1, down = 1;
+	};
+
+	// The frame counts spelled out in the file names of Data/Sprites, read independently of the atlas
+	int FramesAcross(const std::string& stem, int& down)
+	{
+		down = 1;
+		const size_t underscore = stem.find_last_of('_');
+		if (underscore == std::string::npos)
+		{
+			return 1;
+		}
+		const std::string suffix = stem.substr(underscore + 1);
+		if (suffix.empty() || suffix.find_first_not_of("0123456789x") != std::string::npos)
+		{
+			return 1;
+		}
+		const size_t x = suffix.find('x');
+		if (x != std::string::npos)
+		{
+			down = std::atoi(suffix.c_str() + x + 1);
+		}
+		return std::atoi(suffix.c_str());
+	}
+
+	std::vector<Source> LoadSources()
+	{
+		std::vector<Source> sources;
+		for (const fs::directory_entry& entry : fs::directory_iterator(SPRITES))
+		{
+			if (entry.path().extension() != ".png")
+			{
+				continue;
+			}
+			Source source;
+			source.name = entry.path().stem().string();
+			source.across = FramesAcross(source.name, source.down);
+			std::transform(source.name.begin(), source.name.end(), source.name.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+			source.image = LoadImage(entry.path().string().c_str());
+			ImageFormat(&source.image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+			sources.push_back(source);
+		}
+		return sources;
+	}
+
+	const uint8_t* SourcePixel(const Source& source, int frame, int x, int y)
+	{
+		const int frameW = source.image.width / source.across, frameH = source.image.height / source.down;
+		const int sx = (frame % source.across) * frameW + x, sy = (frame / source.across) * frameH + y;
+		return static_cast<const uint8_t*>(source.image.data) + (static_cast<size_t>(sy) * source.image.width + sx) * 4;
+	}
+
+	bool Overlap(const Rectangle& a, const Rectangle& b)
+	{
+		return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+
+	// Sprite sizes, frame counts and frame rectangles and pixels
+	void CheckLayout(const Play::SpriteAtlas& atlas, const std::vector<Source>& sources, int pageSize)
+	{
+		TEST_CHECK(atlas.sprites.size() == sources.size());
+		TEST_CHECK(atlas.textures.empty());
+		for (const Image& page : atlas.pages)
+		{
+			TEST_CHECK(page.width > 0 && page.width <= pageSize && page.height > 0 && page.height <= pageSize);
+		}
+
+		int frameTotal = 0;
+		for (const Source& source : sources)
+		{
+			const int id = Play::FindSprite(atlas, source.name.c_str());
+			TEST_CHECK(id >= 0);
+			if (id < 0)
+			{
+				continue;
+			}
+			const Play::AtlasSprite& sprite = atlas.sprites[id];
+			TEST_CHECK(sprite.frameCount == source.across * source.down);
+			TEST_CHECK(sprite.width == source.image.width / source.across && sprite.height == source.image.height / source.down);
+			TEST_CHECK(sprite.firstFrame >= 0 && sprite.firstFrame + sprite.frameCount <= static_cast<int>(atlas.frames.size()));
+			frameTotal += sprite.frameCount;
+
+			for (int f = 0; f < sprite.frameCount; f++)
+			{
+				const Play::AtlasFrame& frame = atlas.frames[sprite.firstFrame + f];
+				TEST_CHECK(frame.page >= 0 && frame.page < static_cast<int>(atlas.pages.size()));
+				const Image& page = atlas.pages[frame.page];
+				const Rectangle& r = frame.source;
+				TEST_CHECK(r.width == sprite.width && r.height == sprite.height);
+				TEST_CHECK(r.x >= 0 && r.y >= 0 && r.x + r.width <= page.width && r.y + r.height <= page.height);
+
+				bool same = true;
+				for (int y = 0; y < sprite.height && same; y++)
+				{
+					const uint8_t* row = static_cast<const uint8_t*>(page.data) + ((static_cast<size_t>(r.y) + y) * page.width + static_cast<size_t>(r.x)) * 4;
+					same = std::memcmp(row, SourcePixel(source, f, 0, y), static_cast<size_t>(sprite.width) * 4) == 0;
+				}
+				TEST_CHECK(same);
+			}
+		}
+		TEST_CHECK(frameTotal == static_cast<int>(atlas.frames.size()));
+
+		// No two frames share a pixel
+		for (size_t a = 0; a < atlas.frames.size(); a++)
+		{
+			for (size_t b = a + 1; b < atlas.frames.size(); b++)
+			{
+				TEST_CHECK(atlas.frames[a].page != atlas.frames[b].page || !Overlap(atlas.frames[a].source, atlas.frames[b].source));
+			}
+		}
+	}
+
+	// Draws one frame over a grey target and compares every pixel with the frame blended over grey by hand
+	bool DrawMatches(const Play::SpriteAtlas& atlas, const Source& source, int frame, int x, int y)
+	{
+		std::vector<uint8_t> pixels(TARGET_W * TARGET_H * 4, 0);
+		for (size_t k = 0; k < pixels.size(); k += 4)
+		{
+			pixels[k] = pixels[k + 1] = pixels[k + 2] = 100;
+			pixels[k + 3] = 255;
+		}
+		std::vector<uint8_t> expected = pixels;
+
+		const int frameCount = source.across * source.down;
+		const int wrapped = ((frame % frameCount) + frameCount) % frameCount;
+		const int frameW = source.image.width / source.across, frameH = source.image.height / source.down;
+		for (int row = 0; row < frameH; row++)
+		{
+			for (int col = 0; col < frameW; col++)
+			{
+				if (x + col < 0 || x + col >= TARGET_W || y + row < 0 || y + row >= TARGET_H)
+				{
+					continue;
+				}
+				const uint8_t* src = SourcePixel(source, wrapped, col, row);
+				uint8_t* dst = &expected[(static_cast<size_t>(y + row) * TARGET_W + x + col) * 4];
+				const int a = src[3];
+				for (int c = 0; c < 3; c++)
+				{
+					dst[c] = static_cast<uint8_t>((src[c] * a + dst[c] * (255 - a)) / 255);
+				}
+				dst[3] = static_cast<uint8_t>(a + dst[3] * (255 - a) / 255);
+			}
+		}
+
+		Play::SoftwareTarget target;
+		target.pixels = pixels.data();
+		target.width = TARGET_W;
+		target.height = TARGET_H;
+		target.pitch = TARGET_W * 4;
+		Play::SetSoftwareTarget(&target);
+		Play::DrawSprite(atlas, Play::FindSprite(atlas, source.name.c_str()), frame, { static_cast<float>(x), static_cast<float>(y) });
+		Play::SetSoftwareTarget(nullptr);
+		return pixels == expected;
+	}
+
+}
+#pragma endregion
+
+int main()
+{
+	if (!fs::is_directory(SPRITES))
+	{
+		std::printf("No sprites at %s\n", SPRITES);
+		return Test::SKIP_CODE;
+	}
+
+	const std::vector<Source> sources = LoadSources();
+	TEST_CHECK(!sources.empty());
+
+	Play::SpriteAtlas atlas;
+	TEST_CHECK(Play::LoadSpriteAtlas(atlas, SPRITES));
+	CheckLayout(atlas, sources, 2048);
+
+	// Frame counts from the names the game's art uses, spelled out
+	const auto frames = [&atlas](const char* name)
+	{
+		const int id = Play::FindSprite(atlas, name);
+		return id < 0 ? -1 : atlas.sprites[id].frameCount;
+	};
+	TEST_CHECK(frames("agent8_climb_4") == 4);
+	TEST_CHECK(frames("font32px_10x10") == 100);
+	TEST_CHECK(frames("star") == 1);
+	TEST_CHECK(Play::FindSprite(atlas, "Star") >= 0 && Play::FindSprite(atlas, "Star") == Play::FindSprite(atlas, "STAR"));
+	TEST_CHECK(Play::FindSprite(atlas, "no such sprite") == -1);
+
+	// Inside the target, clipped at each edge, and with frame numbers past either end
+	for (const Source& source : sources)
+	{
+		const int frameW = source.image.width / source.across, frameH = source.image.height / source.down;
+		const int frameCount = source.across * source.down;
+		TEST_CHECK(DrawMatches(atlas, source, 0, 3, 5));
+		TEST_CHECK(DrawMatches(atlas, source, frameCount - 1, -frameW / 2, -frameH / 3));
+		TEST_CHECK(DrawMatches(atlas, source, frameCount + 1, TARGET_W - frameW / 2, TARGET_H - frameH / 4));
+		TEST_CHECK(DrawMatches(atlas, source, -1, 7, TARGET_H - 10));
+	}
+	Play::UnloadSpriteAtlas(atlas);
+	TEST_CHECK(atlas.pages.empty() && atlas.sprites.empty());
+
+	// Pages too small for everything: the same frames spread over several
+	TEST_CHECK(Play::LoadSpriteAtlas(atlas, SPRITES, SMALL_PAGE));
+	TEST_CHECK(atlas.pages.size() > 1);
+	CheckLayout(atlas, sources, SMALL_PAGE);
+	TEST_CHECK(DrawMatches(atlas, sources.back(), 0, 1, 1));
+	Play::UnloadSpriteAtlas(atlas);
+
+	TEST_CHECK(!Play::LoadSpriteAtlas(atlas, "Data/NoSuchDirectory"));
+
+	for (const Source& source : sources)
+	{
+		UnloadImage(source.image);
+	}
+	return Test::Finish("SpriteAtlasTest");
+}
@@ -0,0 +1,177 @@
+// Includes
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Play.h"
+#include "TestCommon.h"
+
+// SpriteCacheTest.cpp
+// Checks that sprites created from SpriteCache.bin are the sprites a fresh load gives, and that the cache is only
+// trusted while it matches the sprite directory. Works on a copy of Data/Sprites in the temporary directory.
+// - Each load records every sprite's name, size, frames, origin and canvas pixels, and draws every frame so the
+//   pre-multiplied pixels are compared too
+// - The cache must be used as is when nothing changed, rebuilt after a .inf change and after being damaged, and
+//   recolouring a cached sprite must not reach the file
+//
+// Usage: SpriteCacheTest [sprite directory]
+
+#pragma region Helpers
+namespace {
+
+	namespace fs = std::filesystem;
+
+	constexpr int DISPLAY_WIDTH = 640;
+	constexpr int DISPLAY_HEIGHT = 480;
+	constexpr const char* CACHE_FILE = "SpriteCache.bin";
+
+	struct SpriteSet
+	{
+		std::vector<std::string> names;
+		std::vector<float> layout;     // width, height, frames, originX, originY for each sprite
+		std::vector<uint32_t> canvas;  // every sprite's canvas pixels, one after another
+		std::vector<uint32_t> drawn;   // the display after drawing every frame of every sprite
+
+		bool operator==(const SpriteSet& other) const
+		{
+			return names == other.names && layout == other.layout && canvas == other.canvas && drawn == other.drawn;
+		}
+	};
+
+	std::vector<uint8_t> ReadAll(const fs::path& file)
+	{
+		std::vector<uint8_t> bytes;
+		Play::ReadFileBytes(file.string(), bytes);
+		return bytes;
+	}
+
+	// Creates the graphics manager over `directory`, records the sprites and destroys it again
+	SpriteSet Load(const fs::path& directory)
+	{
+		using namespace Play;
+
+		Graphics::CreateManager(DISPLAY_WIDTH, DISPLAY_HEIGHT, (directory.string() + "/").c_str());
+		Window::CreateManager(Graphics::GetDrawingBuffer(), 1);
+
+		SpriteSet set;
+		Graphics::ClearBuffer(0xFF203040);
+		for (int id = 0; id < Graphics::GetTotalLoadedSprites(); id++)
+		{
+			const Vector2f size = Graphics::GetSpriteSize(id);
+			const Vector2f origin = Graphics::GetSpriteOrigin(id);
+			set.names.push_back(Graphics::GetSpriteName(id));
+			set.layout.insert(set.layout.end(), { size.width, size.height, static_cast<float>(Graphics::GetSpriteFrames(id)), origin.x, origin.y });
+
+			const PixelData* pixels = Graphics::GetSpritePixelData(id);
+			const uint32_t* bits = reinterpret_cast<const uint32_t*>(pixels->pPixels);
+			set.canvas.insert(set.canvas.end(), bits, bits + static_cast<size_t>(pixels->width) * pixels->height);
+
+			for (int frame = 0; frame < Graphics::GetSpriteFrames(id); frame++)
+			{
+				const Point2f pos{ static_cast<float>((id * 97 + frame * 31) % DISPLAY_WIDTH), static_cast<float>((id * 53 + frame * 17) % DISPLAY_HEIGHT) };
+				Graphics::DrawTransparent(id, pos, frame);
+				Graphics::DrawTransparent(id, pos + Point2f{ 5.0f, 7.0f }, frame, { 0.5f, 1.0f, 0.8f, 0.6f });
+			}
+		}
+		const PixelData* display = Graphics::GetDrawingBuffer();
+		const uint32_t* bits = reinterpret_cast<const uint32_t*>(display->pPixels);
+		set.drawn.assign(bits, bits + static_cast<size_t>(display->width) * display->height);
+
+		Window::DestroyManager();
+		Graphics::DestroyManager();
+		return set;
+	}
+
+}
+#pragma endregion
+
+int main(int argc, char** argv)
+{
+	const fs::path source = argc > 1 ? argv[1] : "Data/Sprites";
+	if (!fs::exists(source))
+	{
+		std::printf("No sprite directory at %s\n", source.string().c_str());
+		return Test::SKIP_CODE;
+	}
+
+	// A private copy, so the game's own cache is left alone
+	const fs::path directory = fs::temp_directory_path() / "PlaySpriteCacheTest";
+	fs::remove_all(directory);
+	fs::create_directories(directory);
+	for (const auto& entry : fs::directory_iterator(source))
+	{
+		if (entry.path().filename() != CACHE_FILE)
+		{
+			fs::copy_file(entry.path(), directory / entry.path().filename());
+		}
+	}
+	const fs::path cacheFile = directory / CACHE_FILE;
+
+	// Cold: everything is decoded and the cache written
+	const SpriteSet decoded = Load(directory);
+	TEST_CHECK(!decoded.names.empty());
+	TEST_CHECK(fs::exists(cacheFile));
+	const std::vector<uint8_t> cache = ReadAll(cacheFile);
+
+	// Warm: the same sprites from the cache, which is left as it was
+	TEST_CHECK(Load(directory) == decoded);
+	TEST_CHECK(ReadAll(cacheFile) == cache);
+
+	// Recolouring a cached sprite changes the copy in memory, never the file
+	Play::Graphics::CreateManager(DISPLAY_WIDTH, DISPLAY_HEIGHT, (directory.string() + "/").c_str());
+	Play::Graphics::ColourSprite(0, 10, 200, 30);
+	Play::Graphics::DestroyManager();
+	TEST_CHECK(ReadAll(cacheFile) == cache);
+	TEST_CHECK(Load(directory) == decoded);
+
+	// Giving a sprite a .inf file with a new origin makes the cache stale, as does taking it away again
+	fs::path infFile;
+	for (const auto& entry : fs::directory_iterator(directory))
+	{
+		if (entry.path().extension() == ".png" && !fs::exists(fs::path(entry.path()).replace_extension(".inf")))
+		{
+			infFile = fs::path(entry.path()).replace_extension(".inf");
+			break;
+		}
+	}
+	if (!infFile.empty())
+	{
+		const std::string origin = "ORIGIN 3 4";
+		Play::WriteFileBytes(infFile.string(), std::vector<uint8_t>(origin.begin(), origin.end()));
+		const SpriteSet edited = Load(directory);
+		TEST_CHECK(edited.names == decoded.names && edited.canvas == decoded.canvas);
+		TEST_CHECK(edited.layout != decoded.layout);
+		TEST_CHECK(ReadAll(cacheFile) != cache);
+
+		fs::remove(infFile);
+		TEST_CHECK(Load(directory) == decoded);
+		TEST_CHECK(ReadAll(cacheFile) == cache);
+	}
+
+	// A damaged cache is ignored and rebuilt: cut short, or with a bit of its magic number, version, sprite count or
+	// pixel size flipped (the first 16 bytes)
+	for (int damage = 0; damage < 40; damage++)
+	{
+		std::vector<uint8_t> bytes = cache;
+		if (damage % 2 == 0)
+		{
+			bytes.resize(bytes.size() * damage / 40);
+		}
+		else
+		{
+			bytes[damage % 16] ^= static_cast<uint8_t>(1 << (damage % 8));
+		}
+		Play::WriteFileBytes(cacheFile.string(), bytes);
+
+		const SpriteSet loaded = Load(directory);
+		const bool rebuilt = ReadAll(cacheFile) == cache;
+		if (!(loaded == decoded) || !rebuilt)
+		{
+			std::printf("damage %d: sprites %s, cache %s\n", damage, loaded == decoded ? "match" : "differ", rebuilt ? "rebuilt" : "not rebuilt");
+			TEST_CHECK(loaded == decoded && rebuilt);
+		}
+	}
+
+	fs::remove_all(directory);
+	return Test::Finish("SpriteCacheTest");
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// Includes
+#include <cstdio>
+
+// TestCommon.h
+// Shared pieces of the test executables. Each test is a plain executable run by ctest: it prints every
+// failed check and exits non-zero if there were any, or exits with SKIP_CODE when it can't run here.
+namespace Test
+{
+	// Matches SKIP_RETURN_CODE in CMakeLists.txt
+	constexpr int SKIP_CODE = 77;
+
+	inline int& Failures()
+	{
+		static int failures = 0;
+		return failures;
+	}
+
+	inline void Fail(const char* file, int line, const char* what)
+	{
+		std::printf("%s:%d: check failed: %s\n", file, line, what);
+		Failures()++;
+	}
+
+	inline int Finish(const char* name)
+	{
+		std::printf("%s: %s (%d failed checks)\n", name, Failures() == 0 ? "passed" : "FAILED", Failures());
+		return Failures() == 0 ? 0 : 1;
+	}
+}
+
+#define TEST_CHECK(condition) \
+	do { if (!(condition)) Test::Fail(__FILE__, __LINE__, #condition); } while (0)
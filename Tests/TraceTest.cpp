@@ -0,0 +1,268 @@
+// Includes
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+#include "TestCommon.h"
+#include "Trace.h"
+
+// TraceTest.cpp
+// Checks that the trace file is valid JSON whatever the event names hold. Several threads start recording while
+// the trace is being drained, with names and arguments containing quotes, backslashes, control characters and
+// UTF-8; the file is then parsed back with a strict parser, and every event must be there with its strings intact.
+
+#pragma region Helpers
+namespace {
+
+	constexpr int THREADS = 8;
+	constexpr int EVENTS_PER_THREAD = 1500;
+
+	const char* NAMES[] = { "plain", "say \"hi\"", "back\\slash", "line\nbreak\ttab", "bell\x01", "caf\xC3\xA9" };
+	constexpr int NAME_COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+
+	// Strict JSON: one value, nothing after it; strings may only hold the escapes JSON allows
+	class Parser
+	{
+	public:
+		explicit Parser(const std::string& text) : m_text(text) {}
+
+		bool Document()
+		{
+			return Value() && (Space(), m_pos == m_text.size());
+		}
+
+		std::map<std::string, int> names; // the value of every "name" key, and how often it appeared
+		int events = 0;                    // objects inside the top-level array
+
+	private:
+		void Space()
+		{
+			while (m_pos < m_text.size() && std::strchr(" \t\r\n", m_text[m_pos]))
+			{
+				++m_pos;
+			}
+		}
+
+		bool Take(char c)
+		{
+			Space();
+			if (m_pos < m_text.size() && m_text[m_pos] == c)
+			{
+				++m_pos;
+				return true;
+			}
+			return false;
+		}
+
+		bool String(std::string& out)
+		{
+			if (!Take('"'))
+			{
+				return false;
+			}
+			while (m_pos < m_text.size())
+			{
+				const unsigned char c = m_text[m_pos++];
+				if (c == '"')
+				{
+					return true;
+				}
+				if (c < 0x20)
+				{
+					return false;
+				}
+				if (c != '\\')
+				{
+					out += static_cast<char>(c);
+					continue;
+				}
+				if (m_pos >= m_text.size())
+				{
+					return false;
+				}
+				const char escape = m_text[m_pos++];
+				switch (escape)
+				{
+				case '"': out += '"'; break;
+				case '\\': out += '\\'; break;
+				case '/': out += '/'; break;
+				case 'b': out += '\b'; break;
+				case 'f': out += '\f'; break;
+				case 'n': out += '\n'; break;
+				case 'r': out += '\r'; break;
+				case 't': out += '\t'; break;
+				case 'u':
+				{
+					if (m_pos + 4 > m_text.size())
+					{
+						return false;
+					}
+					char* end = nullptr;
+					const std::string hex = m_text.substr(m_pos, 4);
+					const long code = std::strtol(hex.c_str(), &end, 16);
+					if (end != hex.c_str() + 4 || code >= 0x80)
+					{
+						return false; // the writer only escapes control characters
+					}
+					out += static_cast<char>(code);
+					m_pos += 4;
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+			return false;
+		}
+
+		bool Value(int depth = 0)
+		{
+			Space();
+			if (m_pos >= m_text.size())
+			{
+				return false;
+			}
+			const char c = m_text[m_pos];
+			if (c == '"')
+			{
+				std::string ignored;
+				return String(ignored);
+			}
+			if (c == '[')
+			{
+				++m_pos;
+				if (Take(']'))
+				{
+					return true;
+				}
+				do
+				{
+					if (depth == 0)
+					{
+						++events;
+					}
+					if (!Value(depth + 1))
+					{
+						return false;
+					}
+				} while (Take(','));
+				return Take(']');
+			}
+			if (c == '{')
+			{
+				++m_pos;
+				if (Take('}'))
+				{
+					return true;
+				}
+				do
+				{
+					std::string key, value;
+					if (!String(key) || !Take(':'))
+					{
+						return false;
+					}
+					Space();
+					if (key == "name" && m_pos < m_text.size() && m_text[m_pos] == '"')
+					{
+						if (!String(value))
+						{
+							return false;
+						}
+						++names[value];
+					}
+					else if (!Value(depth + 1))
+					{
+						return false;
+					}
+				} while (Take(','));
+				return Take('}');
+			}
+			// Numbers (the writer prints plain decimals)
+			const size_t start = m_pos;
+			while (m_pos < m_text.size() && std::strchr("-+.eE0123456789", m_text[m_pos]))
+			{
+				++m_pos;
+			}
+			return m_pos > start;
+		}
+
+		const std::string& m_text;
+		size_t m_pos = 0;
+	};
+
+	void RecordEvents(int thread)
+	{
+		for (int n = 0; n < EVENTS_PER_THREAD; ++n)
+		{
+			const char* name = NAMES[(thread + n) % NAME_COUNT];
+			switch (n % 3)
+			{
+			case 0: Tracing::Begin("test", name); break;
+			case 1: Tracing::End("test", name); break;
+			default: Tracing::Instant("te\"st", name, NAMES[n % NAME_COUNT], NAMES[(n + 1) % NAME_COUNT], "second", "\\"); break;
+			}
+			if (n % 100 == 0)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+	}
+
+}
+#pragma endregion
+
+int main()
+{
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / "PacmanTraceTest.json";
+	TEST_CHECK(Tracing::Start(file.string().c_str()));
+
+	// Started at staggered times, so first events register while the flusher is writing
+	std::vector<std::thread> threads;
+	for (int t = 0; t < THREADS; ++t)
+	{
+		threads.emplace_back(RecordEvents, t);
+		std::this_thread::sleep_for(std::chrono::milliseconds(3));
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	Tracing::Stop();
+
+	std::string text;
+	{
+		MappedFile mapped;
+		TEST_CHECK(mapped.Open(file.string().c_str()));
+		text.assign(reinterpret_cast<const char*>(mapped.Data()), mapped.Size());
+	}
+
+	Parser parser(text);
+	TEST_CHECK(parser.Document());
+	const uint64_t dropped = Tracing::GetDroppedCount();
+	TEST_CHECK(parser.events + dropped == THREADS * EVENTS_PER_THREAD);
+
+	// Every name comes back exactly as recorded
+	int named = 0;
+	for (const auto& [name, count] : parser.names)
+	{
+		bool known = false;
+		for (const char* expected : NAMES)
+		{
+			known = known || name == expected;
+		}
+		TEST_CHECK(known);
+		named += count;
+	}
+	TEST_CHECK(named == parser.events);
+	std::printf("%d events parsed, %llu dropped\n", parser.events, static_cast<unsigned long long>(dropped));
+
+	std::filesystem::remove(file);
+	return Test::Finish("TraceTest");
+}
@@ -0,0 +1,239 @@
+// Includes
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Play.h"
+#include "TestCommon.h"
+
+// TransformTest.cpp
+// Checks TransformPixels, which solves each row's span inside the sprite and blends it with the span kernels,
+// against a plain per-pixel loop over the whole bounding box which tests every 16.16 sample position and blends
+// with the policies' Blend functions. Random rotations, scales, origins and positions (many partly off screen)
+// are drawn with each blend mode at every SIMD level, and again under a random clip rectangle.
+
+#pragma region Helpers
+namespace {
+
+	using namespace Play;
+	using namespace Play::Render;
+
+	std::mt19937 rng(1);
+
+	// A disc with a soft edge: pre-multiplied with the skip encoding, or unmodified for multiply blends
+	std::vector<Pixel> MakeSprite(int width, int height, bool preMultiplied)
+	{
+		std::vector<Pixel> pixels(static_cast<size_t>(width) * height);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const float dx = x - width / 2 + 0.5f, dy = y - height / 2 + 0.5f;
+				const float distance = std::sqrt(dx * dx + dy * dy) / (width / 2);
+				const uint32_t alpha = distance < 0.9f ? 255 : distance < 1.0f ? static_cast<uint32_t>((1.0f - distance) * 2550) : 0;
+				uint32_t red = rng() & 0xFF, green = rng() & 0xFF, blue = rng() & 0xFF;
+				if (preMultiplied)
+				{
+					red = red * alpha >> 8;
+					green = green * alpha >> 8;
+					blue = blue * alpha >> 8;
+					pixels[y * width + x].bits = ((0xFF - alpha) << 24) | (red << 16) | (green << 8) | blue;
+				}
+				else
+				{
+					pixels[y * width + x].bits = (alpha << 24) | (red << 16) | (green << 8) | blue;
+				}
+			}
+		}
+
+		if (preMultiplied)
+		{
+			for (int y = 0; y < height; y++)
+			{
+				uint32_t run = 0;
+				for (int x = width - 1; x >= 0; x--)
+				{
+					uint32_t& bits = pixels[y * width + x].bits;
+					if ((bits >> 24) == 0xFF)
+					{
+						bits = 0xFF000000 | run++;
+					}
+					else
+					{
+						run = 0;
+					}
+				}
+			}
+		}
+		return pixels;
+	}
+
+	// The same bounding box and 16.16 positions as TransformPixels, but every pixel of the box is tested and blended on its own
+	template <typename TBlend>
+	void ReferenceTransform(const PixelData& srcPixelData, int srcDrawWidth, int srcDrawHeight, const Point2f& srcOrigin, const Matrix2D& transform, BlendColour globalMultiply)
+	{
+		Matrix2D right;
+		right.row[0] = { transform.row[0].x, transform.row[1].x, 0.0f };
+		right.row[1] = { transform.row[0].y, transform.row[1].y, 0.0f };
+		right.row[2] = { transform.row[2].x, m_pRenderTarget->height - transform.row[2].y, 1.0f };
+
+		const float inf = std::numeric_limits<float>::infinity();
+		float minX = inf, minY = inf, maxX = -inf, maxY = -inf;
+		const float x[2] = { -srcOrigin.x, srcDrawWidth - srcOrigin.x };
+		const float y[2] = { -srcOrigin.y, srcDrawHeight - srcOrigin.y };
+		Point2f vertices[4] = { { x[0], y[0] }, { x[1], y[0] }, { x[1], y[1] }, { x[0], y[1] } };
+		for (Point2f& vertex : vertices)
+		{
+			vertex = right.Transform(vertex);
+			minX = std::floor(std::min(minX, vertex.x));
+			maxX = std::ceil(std::max(maxX, vertex.x));
+			minY = std::floor(std::min(minY, vertex.y));
+			maxY = std::ceil(std::max(maxY, vertex.y));
+		}
+
+		if (Determinant(right) == 0.0f)
+		{
+			return;
+		}
+		Matrix2D inverse = right;
+		inverse.Inverse();
+
+		// Off the top or left of the render target, the walk starts from the first pixel on it
+		minX = std::max(minX, 0.0f);
+		minY = std::max(minY, 0.0f);
+
+		const Point2f start = inverse.Transform(Point2f{ minX, minY }) + srcOrigin;
+		const int64_t startX = ToFixed16(start.x + 0.5f), startY = ToFixed16(start.y + 0.5f);
+		const int64_t stepXX = ToFixed16(inverse.row[0].x), stepXY = ToFixed16(inverse.row[0].y);
+		const int64_t stepYX = ToFixed16(inverse.row[1].x), stepYY = ToFixed16(inverse.row[1].y);
+
+		for (int row = 0; row < static_cast<int>(maxY - minY); row++)
+		{
+			const int destY = static_cast<int>(minY) + row;
+			for (int column = 0; column < static_cast<int>(maxX - minX); column++)
+			{
+				const int destX = static_cast<int>(minX) + column;
+				const int64_t sampleX = startX + row * stepYX + column * stepXX;
+				const int64_t sampleY = startY + row * stepYY + column * stepXY;
+				if (destX < 0 || destY < 0 || destX >= m_pRenderTarget->width || destY >= m_pRenderTarget->height ||
+					sampleX < 0 || sampleY < 0 || sampleX >= (int64_t(srcDrawWidth) << 16) || sampleY >= (int64_t(srcDrawHeight) << 16))
+				{
+					continue;
+				}
+
+				uint32_t* src = &srcPixelData.pPixels[(sampleY >> 16) * srcPixelData.width + (sampleX >> 16)].bits;
+				uint32_t* dest = &m_pRenderTarget->pPixels[destY * m_pRenderTarget->width + destX].bits;
+				TBlend::Blend(src, dest, globalMultiply);
+			}
+		}
+	}
+
+	enum Mode { ALPHA, ADDITIVE, MULTIPLY, MODE_COUNT };
+
+}
+#pragma endregion
+
+int main()
+{
+	const int WIDTH = 640, HEIGHT = 480, SPRITE_WIDTH = 256, SPRITE_HEIGHT = 256;
+	std::vector<Pixel> background(WIDTH * HEIGHT), pixels(WIDTH * HEIGHT);
+	for (Pixel& pixel : background)
+	{
+		pixel.bits = rng() | 0xFF000000;
+	}
+	PixelData target{ WIDTH, HEIGHT, pixels.data() };
+	SetRenderTarget(&target);
+
+	std::vector<Pixel> preMultiplied = MakeSprite(SPRITE_WIDTH, SPRITE_HEIGHT, true);
+	std::vector<Pixel> canvas = MakeSprite(SPRITE_WIDTH, SPRITE_HEIGHT, false);
+	const PixelData preMultipliedData{ SPRITE_WIDTH, SPRITE_HEIGHT, preMultiplied.data(), true };
+	const PixelData canvasData{ SPRITE_WIDTH, SPRITE_HEIGHT, canvas.data(), false };
+
+	const SimdLevel detected = DetectSimdLevel();
+	int draws = 0;
+	for (int trial = 0; trial < 300; trial++)
+	{
+		float angle = (rng() % 6283) / 1000.0f;
+		float scaleX = 0.3f + (rng() % 300) / 100.0f, scaleY = 0.3f + (rng() % 300) / 100.0f;
+		if (trial % 7 == 0)
+		{
+			angle = 0.0f;
+			scaleX = scaleY = 1.0f;
+		}
+		else if (trial % 11 == 0)
+		{
+			angle = PLAY_PI / 2.0f;
+		}
+		Matrix2D transform = MatrixScale(scaleX, scaleY) * MatrixRotation(angle);
+		transform.row[2] = { static_cast<float>(rng() % 900) - 130.0f, static_cast<float>(rng() % 700) - 110.0f, 1.0f };
+		const Point2f origin{ static_cast<float>(rng() % SPRITE_WIDTH), static_cast<float>(rng() % SPRITE_HEIGHT) };
+		const BlendColour globalMultiply{ (rng() % 101) / 100.0f, (rng() % 101) / 100.0f, (rng() % 101) / 100.0f, (rng() % 101) / 100.0f };
+		const int left = rng() % WIDTH, top = rng() % HEIGHT;
+		const ClipRect clip{ left, top, left + 1 + static_cast<int>(rng() % (WIDTH - left)), top + 1 + static_cast<int>(rng() % (HEIGHT - top)) };
+		const Mode mode = static_cast<Mode>(trial % MODE_COUNT);
+
+		auto draw = [&](bool reference)
+		{
+			pixels = background;
+			switch (mode)
+			{
+			case ALPHA:
+				reference ? ReferenceTransform<AlphaBlendPolicy>(preMultipliedData, SPRITE_WIDTH, SPRITE_HEIGHT, origin, transform, globalMultiply)
+					: TransformPixels<AlphaBlendPolicy>(preMultipliedData, 0, SPRITE_WIDTH, SPRITE_HEIGHT, origin, transform, globalMultiply);
+				break;
+			case ADDITIVE:
+				reference ? ReferenceTransform<AdditiveBlendPolicy>(preMultipliedData, SPRITE_WIDTH, SPRITE_HEIGHT, origin, transform, globalMultiply)
+					: TransformPixels<AdditiveBlendPolicy>(preMultipliedData, 0, SPRITE_WIDTH, SPRITE_HEIGHT, origin, transform, globalMultiply);
+				break;
+			default:
+				reference ? ReferenceTransform<MultiplyBlendPolicy>(canvasData, SPRITE_WIDTH, SPRITE_HEIGHT, origin, transform, globalMultiply)
+					: TransformPixels<MultiplyBlendPolicy>(canvasData, 0, SPRITE_WIDTH, SPRITE_HEIGHT, origin, transform, globalMultiply);
+				break;
+			}
+			return pixels;
+		};
+
+		const std::vector<Pixel> expected = draw(true);
+		for (int level = 0; level <= static_cast<int>(detected); level++)
+		{
+			SetSimdLevel(static_cast<SimdLevel>(level));
+			const std::vector<Pixel> actual = draw(false);
+			draws++;
+
+			int different = 0;
+			for (int i = 0; i < WIDTH * HEIGHT; i++)
+			{
+				different += actual[i].bits != expected[i].bits;
+			}
+			if (different > 0)
+			{
+				std::printf("trial %d mode %d level %d: %d pixels differ from the per-pixel loop\n", trial, mode, level, different);
+				TEST_CHECK(different == 0);
+			}
+
+			// Clipped, the same pixels are drawn inside the rectangle and none outside it
+			SetClipRect(clip);
+			const std::vector<Pixel> clipped = draw(false);
+			ClearClipRect();
+			different = 0;
+			for (int y = 0; y < HEIGHT; y++)
+			{
+				for (int x = 0; x < WIDTH; x++)
+				{
+					const bool inside = x >= clip.left && x < clip.right && y >= clip.top && y < clip.bottom;
+					different += clipped[y * WIDTH + x].bits != (inside ? actual : background)[y * WIDTH + x].bits;
+				}
+			}
+			if (different > 0)
+			{
+				std::printf("trial %d mode %d level %d: %d pixels differ when clipped\n", trial, mode, level, different);
+				TEST_CHECK(different == 0);
+			}
+		}
+	}
+	SetSimdLevel(detected);
+	std::printf("%d transformed draws compared\n", draws);
+
+	return Test::Finish("TransformTest");
+}